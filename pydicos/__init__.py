@@ -1,4 +1,5 @@
-from ._dicosio import dcsread, dcswrite
+from ._dicosio import dcsread, dcsread_many, dcswrite
+from ._network import areceive
 from ._loaders import *
 from .utils.time import DicosDateTime
 from pydicos.version import _version as __version__
@@ -1,7 +1,19 @@
 from ._loaders import CTLoader, DXLoader, TDRLoader
+from pyDICOS import ErrorLog, probe_modality, read_many
 import logging
 from pathlib import Path
-from typing import Optional, Union
+from typing import Any, List, Optional, Sequence, Tuple, Union
+
+
+_LOADERS = {"CT": CTLoader, "DX": DXLoader, "TDR": TDRLoader}
+
+
+def _candidate_loaders(filename: str) -> list:
+    """Loaders to try for a file, from its meta header if it can be probed."""
+    DCSLoader = _LOADERS.get(probe_modality(filename))
+    if DCSLoader is not None:
+        return [DCSLoader]
+    return [CTLoader, DXLoader, TDRLoader]
 
 
 def dcsread(
@@ -10,6 +22,10 @@ def dcsread(
 ) -> Union[CTLoader, DXLoader, TDRLoader]:
     """Read a DICOS file.
 
+    The modality is probed from the file meta header so that only the matching
+    loader parses the file. Files without a readable SOP Class UID fall back to
+    trying the CT, DX and TDR loaders in turn.
+
     Parameters
     ----------
     filename : str|Path
@@ -31,7 +47,7 @@ def dcsread(
         dcs.read(str(filename))
         return dcs
 
-    for DCSLoader in [CTLoader, DXLoader, TDRLoader]:
+    for DCSLoader in _candidate_loaders(str(filename)):
         try:
             dcs_loader: Union[CTLoader, DXLoader, TDRLoader] = DCSLoader()
             dcs_loader.read(str(filename))
@@ -43,6 +59,58 @@ def dcsread(
     raise ValueError(f"Invalid DICOS file: {filename}")
 
 
+def dcsread_many(
+    filenames: Sequence[Union[str, Path]],
+    max_workers: Optional[int] = None,
+    return_data: bool = False,
+) -> List[Tuple[Any, ErrorLog]]:
+    """Read many DICOS files in parallel.
+
+    The files are decoded by a pool of native threads that run without the GIL.
+    Loaders are picked as in `dcsread`: from the probed modality when possible,
+    otherwise CT, DX then TDR, each pass only retrying the files the previous
+    one could not read.
+
+    Parameters
+    ----------
+    filenames : list of str|Path
+        The names of the files to read.
+    max_workers : int, optional
+        The maximum number of reader threads.
+        The default is None and will use one thread per core.
+    return_data : bool, optional
+        If True, return the output of `get_data()` instead of the loader.
+
+    Returns
+    -------
+    results : list of (dcs, ErrorLog)
+        One entry per file, in input order. `dcs` is the loader (or its data)
+        and None if the file could not be read, in which case the ErrorLog
+        of the last attempted loader tells why.
+    """
+    filenames = [str(filename) for filename in filenames]
+    results: List[Tuple[Any, ErrorLog]] = [(None, ErrorLog()) for _ in filenames]
+    candidates = [_candidate_loaders(filename) for filename in filenames]
+    pending = list(range(len(filenames)))
+
+    while pending:
+        items = [(candidates[n].pop(0)(), filenames[n], ErrorLog()) for n in pending]
+        success = read_many(items, max_workers or 0)
+
+        failed = []
+        for n, (dcs, _, err), ok in zip(pending, items, success):
+            if ok:
+                results[n] = (dcs.get_data() if return_data else dcs, err)
+            else:
+                logging.debug(f"Loading {filenames[n]} failed with {type(dcs)}")
+                results[n] = (None, err)
+                if candidates[n]:
+                    failed.append(n)
+        pending = failed
+
+    return results
+
+
 def dcswrite(dcs: Union[CTLoader, DXLoader, TDRLoader], filename: Union[str, Path]):
     """Write a DICOS file.
 
@@ -1,3 +1,4 @@
+import warnings
 import numpy as np
 from pathlib import Path
 from pyDICOS import (
@@ -6,7 +7,6 @@ from pyDICOS import (
     DcsUniqueIdentifier,
     Array1DPoint3Dfloat,
     Bitmap,
-    MemoryBuffer,
     DcsDate,
     DcsDateTime,
     DcsLongText,
@@ -18,17 +18,25 @@ from pyDICOS import (
     Volume,
     Filename,
     ErrorLog,
+    probe_pixel_data,
 )
 from typing import Optional, Union
 
 from .TDR import TDRLoader
 from .ATR import ATRSettings
+from .LazyVolume import LazyVolume, is_uncompressed, map_pixel_data
 
 
 # This class can be utilized to load a CT object by either reading a CT file or using a provided CT object.
 # The 'get_data' function returns a list of 2D NumPy arrays.
 class CTLoader(CT):
-    def __init__(self, filename: Optional[Union[str, Path]] = None) -> None:
+    def __init__(
+        self,
+        filename: Optional[Union[str, Path]] = None,
+        metadata_only: bool = False,
+        lazy: bool = False,
+        mmap: bool = False,
+    ) -> None:
         """Initialize the CTLoader class.
 
         Parameters
@@ -36,26 +44,88 @@ class CTLoader(CT):
         filename : str|Path, optional
             The name of the file to read.
             The default is None and will create an empty CT.
+        metadata_only : bool, optional
+            If True, the pixel data of the file is not decoded.
+            The default is False.
+        lazy : bool, optional
+            If True, the slices of an uncompressed single-section file are only read
+            when accessed through `get_data`.
+            The default is False.
+        mmap : bool, optional
+            If True, `get_data` returns read-only views mapping the file when possible.
+            The default is False.
         """
         super().__init__()
+        self._file_data = None
+        self._data_keep_alive = []
+        self._pixel_data_skipped = False
+        self.pixel_data_decoded = False
 
         if filename is not None:
-            self.read(filename)
+            self.read(filename, metadata_only, lazy, mmap)
 
-    def read(self, filename: Union[str, Path]) -> None:
+    def read(
+        self,
+        filename: Union[str, Path],
+        metadata_only: bool = False,
+        lazy: bool = False,
+        mmap: bool = False,
+    ) -> None:
         """Reads the object from a file.
 
         Parameters
         ----------
         filename : str|Path
             The name of the file to read.
+        metadata_only : bool, optional
+            If True, parsing stops at the pixel data: UIDs, dates, geometry and
+            the other attributes are read but no image data is decoded. If the file
+            cannot be cut at its pixel data it is read whole, with a warning, and
+            `pixel_data_decoded` is set. Otherwise the object cannot be written.
+            The default is False.
+        lazy : bool, optional
+            If True and the file is uncompressed, the attributes are read now and `get_data`
+            returns a `LazyVolume` reading the slices it is indexed with from the file.
+            Lazy reading only applies to uncompressed single-section files: compressed and
+            multi-section files are decoded once, right away, as if lazy were False.
+            The default is False.
+        mmap : bool, optional
+            If True and the file is uncompressed, the attributes are read now and `get_data`
+            returns a read-only view mapping the pixel data of the file, shared through the
+            page cache. Compressed and multi-section files are decoded as usual.
+            The default is False.
         """
+        pixel_data = None
+        if (lazy or mmap) and not metadata_only:
+            # A single header scan decides between reading the slices from the file and decoding it whole
+            pixel_data = probe_pixel_data(str(filename))
+            if not is_uncompressed(pixel_data):
+                lazy = mmap = False
+
         _err = ErrorLog()
-        if not self.Read(Filename(str(filename)), _err, None):
+        if metadata_only or lazy or mmap:
+            _ok, self.pixel_data_decoded = self.read_metadata(Filename(str(filename)), _err, None)
+            if _ok and metadata_only and self.pixel_data_decoded:
+                warnings.warn(f"Read all of {filename}, its pixel data could not be skipped")
+        else:
+            _ok, self.pixel_data_decoded = self.Read(Filename(str(filename)), _err, None), True
+        if not _ok:
             raise RuntimeError(
             f"Failed to read DICOS file: {filename}\n{_err.GetErrorLog().Get()}"
         )
 
+        # The sections were replaced, the memory they adopted can go
+        self._data_keep_alive = []
+        self._pixel_data_skipped = metadata_only and not self.pixel_data_decoded
+        self._file_data = None
+        if (lazy or mmap) and not metadata_only and not self.pixel_data_decoded:
+            if self.GetNumberOfSections() != 1:
+                self.read(filename)
+            elif mmap:
+                self._file_data = [map_pixel_data(filename, pixel_data)]
+            else:
+                self._file_data = [LazyVolume(filename, pixel_data=pixel_data)]
+
     def write(self, filename: Union[str, Path]) -> None:
         """Writes the object to a file.
 
@@ -63,7 +133,20 @@ class CTLoader(CT):
         ----------
         filename : str|Path
             The name of the file to write.
+
+        Raises
+        ------
+        RuntimeError
+            If the object was read with `metadata_only` and holds no pixel data, or the write fails.
+
+        Notes
+        -----
+        The slices of a lazily read file are loaded into the section first, and stay in memory.
         """
+        if self._pixel_data_skipped:
+            raise RuntimeError(f"Cannot write {filename}: the pixel data was not read (metadata_only=True)")
+        if self._file_data is not None:
+            self._load_file_data()
         _err = ErrorLog()
         if not self.Write(
             Filename(str(filename)), _err, CT.TRANSFER_SYNTAX.enumLosslessJPEG
@@ -72,61 +155,86 @@ class CTLoader(CT):
             f"Failed to write DICOS file: {filename}\n{_err.GetErrorLog().Get()}"
         )
 
-    def get_data(self) -> list:
+    def _load_file_data(self) -> None:
+        # Pixels read lazily from the file are only in _file_data, the section is empty
+        volume = self.GetSectionByIndex(0).GetPixelData()
+        self._data_keep_alive = [volume.set_data(volume, np.array(self._file_data[0], copy=True), False)]
+        self._file_data = None
+
+    def get_data(self, copy: bool = False) -> list:
         """Get the data from the CT object.
 
+        Parameters
+        ----------
+        copy : bool, optional
+            If False (default), sections whose slices are contiguous in memory are returned
+            as views sharing the memory of this object. If True, the data is always copied.
+
         Returns
         -------
         data_arrays : list
-            A list of 3D NumPy arrays.
+            A list of 3D NumPy arrays, one per section, with the section data type.
+            For lazily read files, a list with a single `LazyVolume`, and for mapped
+            files a list with a single read-only array. With copy=True, both are
+            returned as arrays in memory.
         """
-        data_arrays = []
-        sectionIt = self.Begin()
-
-        sectionCount = 0
-        while sectionIt != self.End():
-            # get the section from CTObject iterator
-            pSection = sectionIt.deref()
-            pixel_data_type = pSection.GetPixelDataType()
-            # The IMAGE_DATA_TYPE enumeration is situated in the binding code of the Volume Module.
-            if pixel_data_type == Volume.IMAGE_DATA_TYPE.enumUnsigned16Bit:
-                volume = pSection.GetPixelData()
-                depth_size = volume.GetDepth()
-                height_size = volume.GetUnsigned16().GetHeight()
-                width_size = volume.GetUnsigned16().GetWidth()
-
-                data_array = np.zeros(
-                    (depth_size, height_size, width_size), dtype=np.uint16
-                )
+        if self._file_data is not None:
+            return [np.array(data) if copy else data for data in self._file_data]
+        return self.get_sections_data(copy)
 
-                for i in range(volume.GetDepth()):
-                    xyPlane = volume.GetUnsigned16()[i]
-                    data_array[i] = np.array(xyPlane, copy=False)
-
-                data_arrays.append(data_array)
-            next(sectionIt)
-            sectionCount += 1
-        return data_arrays
-    
-    def set_data(self, data: list) -> None:
+    def set_data(self, data: list, copy: bool = False) -> None:
         """Set the data in the CT object.
 
         Parameters
         ----------
         data : list
-            A list of 3D NumPy arrays.
+            A list of 3D NumPy arrays of any supported data type.
+        copy : bool, optional
+            If False (default), the sections share the memory of the arrays, which are kept
+            alive by this object. Arrays that are not C-contiguous and writeable are copied.
+            If True, the data is always copied into memory owned by the sections.
         """
 
         self.SetNumberOfSections(len(data))
+        self._data_keep_alive = []
+        self._pixel_data_skipped = False
+        self._file_data = None
 
         for n, array in enumerate(data):
             assert array.ndim == 3, "Data must be 3D"
-            assert array.dtype == np.uint16, "Data must be uint16"
 
             section = self.GetSectionByIndex(n)
             section.SetRescaleType(DcsLongString("MHU"))
             volume = section.GetPixelData()
-            volume.set_data(volume, array)
+            keep_alive = volume.set_data(volume, array, copy)
+            if keep_alive is not None:
+                self._data_keep_alive.append(keep_alive)
+
+    def allocate_contiguous(
+        self, section: int, data_type: Volume.IMAGE_DATA_TYPE, width: int, height: int, depth: int
+    ) -> np.ndarray:
+        """Allocate the slices of a section back to back in one aligned, zeroed slab.
+
+        Parameters
+        ----------
+        section : int
+            The index of the section, which must exist.
+        data_type : Volume.IMAGE_DATA_TYPE
+            The data type of the section.
+        width, height, depth : int
+            The size of the section.
+
+        Returns
+        -------
+        data_array : numpy.ndarray
+            A writeable (depth, height, width) array over the slab, shared with the section.
+            This object keeps the slab alive until the data is set again.
+        """
+        self._file_data = None
+        volume = self.GetSectionByIndex(section).GetPixelData()
+        slab = volume.allocate_contiguous(volume, data_type, width, height, depth)
+        self._data_keep_alive.append(slab)
+        return slab
 
     def generate_tdr(self, data: dict, output_file: str = None) -> TDRLoader:
         """Generate a TDR file from the CT object and detections.
@@ -228,12 +336,8 @@ class CTLoader(CT):
                     assert pto["Bitmap"].ndim == 3, "Bitmap must be a 3D numpy array"
                     assert pto["Bitmap"].shape == (pto["Extent"]["x"], pto["Extent"]["y"], pto["Extent"]["z"]), "Bitmap shape must match the extent"
                     if pto["Bitmap"].sum() != 0:
-                        threat_bitmap.SetDims(pto["Bitmap"].shape[0], pto["Bitmap"].shape[1], pto["Bitmap"].shape[2], True)
-                        flat_bitmap = pto["Bitmap"].astype(np.uint8).ravel()
-                        byte_array = np.packbits(flat_bitmap, bitorder="little")
-                        byte_buffer = MemoryBuffer()
-                        byte_buffer.SetBuffer(byte_array.tobytes(), byte_array.size)
-                        threat_bitmap.SetBitmapData(byte_buffer, True)
+                        # The bitmap is given as (x, y, z), Bitmap.from_numpy expects (z, y, x)
+                        threat_bitmap = Bitmap.from_numpy(pto["Bitmap"].transpose(2, 1, 0))
                         assert threat_bitmap.GetNumBits() == pto["Bitmap"].size, "Failed to set bitmap"
 
                 tdr.SetThreatRegionOfInterest(
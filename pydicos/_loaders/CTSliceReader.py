@@ -0,0 +1,109 @@
+import numpy as np
+import queue
+import threading
+import warnings
+from pathlib import Path
+from pyDICOS import probe_pixel_data
+from typing import Iterator, Tuple, Union
+
+from .CT import CTLoader
+from .LazyVolume import is_uncompressed
+
+
+# This class can be utilized to iterate over the slices of a CT file with bounded memory.
+# Slices of uncompressed single-section files are read ahead by a background thread into
+# a ring of reused buffers, so at most `ring_size` slices are held in memory.
+# Memory is only bounded for those files: compressed and multi-section files are decoded
+# in full by the SDK, which holds every section in memory, and their slices are yielded as views.
+class CTSliceReader:
+    def __init__(self, filename: Union[str, Path], ring_size: int = 4) -> None:
+        """Initialize the CTSliceReader class.
+
+        Parameters
+        ----------
+        filename : str|Path
+            The name of the file to read.
+        ring_size : int, optional
+            The number of slice buffers shared by the reader thread and the consumer.
+            The default is 4.
+        """
+        if ring_size < 1:
+            raise ValueError("ring_size must be at least 1")
+        self.filename = str(filename)
+        self.ring_size = ring_size
+
+    def __iter__(self) -> Iterator[Tuple[int, int, np.ndarray]]:
+        """Iterate over the slices of the file.
+
+        Yields
+        ------
+        section_index, z, data : int, int, numpy.ndarray
+            The (height, width) slice z of the section. The array is a buffer of the ring
+            that is reused once the iteration moves on: copy it to keep it.
+
+        Notes
+        -----
+        Only uncompressed single-section files are read with bounded memory. Other files,
+        and files whose metadata cannot be read without their pixel data, are decoded whole
+        before the first slice is yielded, so memory grows with the size of the volume.
+        """
+        header = None
+        pixel_data = probe_pixel_data(self.filename)
+        if is_uncompressed(pixel_data):
+            with warnings.catch_warnings():
+                # A full read is not lost, its slices are yielded below
+                warnings.simplefilter("ignore")
+                header = CTLoader(self.filename, metadata_only=True)
+            if header.GetNumberOfSections() == 1 and not header.pixel_data_decoded:
+                yield from self._read_ahead(pixel_data)
+                return
+
+        ct_object = header if header is not None and header.pixel_data_decoded else CTLoader(self.filename)
+        for section_index, data in enumerate(ct_object.get_data()):
+            for z in range(data.shape[0]):
+                yield section_index, z, data[z]
+
+    def _read_ahead(self, pixel_data: dict) -> Iterator[Tuple[int, int, np.ndarray]]:
+        frames, rows, columns = pixel_data["shape"]
+        free = queue.Queue()
+        for _ in range(self.ring_size):
+            free.put(np.empty((rows, columns), dtype=pixel_data["dtype"]))
+        ready = queue.Queue()
+        stop = threading.Event()
+
+        def read_slices():
+            try:
+                with open(self.filename, "rb") as file:
+                    file.seek(pixel_data["offset"])
+                    for z in range(frames):
+                        buffer = free.get()
+                        if stop.is_set():
+                            return
+                        # readinto releases the GIL while the slice is read
+                        if file.readinto(memoryview(buffer).cast("B")) != buffer.nbytes:
+                            raise RuntimeError(f"Truncated pixel data in {self.filename}")
+                        ready.put((z, buffer))
+                ready.put(None)
+            except BaseException as e:
+                ready.put(e)
+
+        reader = threading.Thread(target=read_slices, daemon=True)
+        reader.start()
+        previous = None
+        try:
+            while True:
+                # The consumer is done with the previous slice once it asks for the next one
+                if previous is not None:
+                    free.put(previous)
+                    previous = None
+                item = ready.get()
+                if item is None:
+                    break
+                if isinstance(item, BaseException):
+                    raise item
+                z, previous = item
+                yield 0, z, previous
+        finally:
+            stop.set()
+            free.put(None)
+            reader.join()
@@ -0,0 +1,131 @@
+import numpy as np
+import os
+import tempfile
+from pathlib import Path
+from pyDICOS import CT, ErrorLog, Filename
+from typing import Optional, Union
+
+
+# This class can be utilized to write a CT file from slices that arrive one at a time.
+# It spools, then writes: the file is not encoded as slices arrive. Each slice is flushed raw
+# to a spool file next to the output as soon as it is appended, so only the slice being appended
+# is held in memory. On close, the spooled slices are mapped and adopted by the section volume
+# without a copy, and the SDK writes the whole CT at once, since it only writes complete objects.
+# The output file only exists once close returns, close takes as long as a full write, and the
+# spool needs room on disk for the raw volume. A compressed transfer syntax is encoded on close.
+class CTStreamWriter:
+    def __init__(
+        self,
+        ct: CT,
+        filename: Union[str, Path],
+        transfer_syntax=CT.TRANSFER_SYNTAX.enumLittleEndianExplicit,
+        section: int = 0,
+    ) -> None:
+        """Initialize the CTStreamWriter class.
+
+        Parameters
+        ----------
+        ct : CT
+            The CT object holding the metadata of the file, e.g. a CTLoader read with
+            metadata_only=True. The pixel data of the section is replaced on close.
+        filename : str|Path
+            The name of the file to write.
+        transfer_syntax : TRANSFER_SYNTAX, optional
+            The transfer syntax of the file. The default is enumLittleEndianExplicit,
+            which writes the spooled slices without re-encoding them. Other transfer
+            syntaxes encode the whole volume on close.
+        section : int, optional
+            The index of the section receiving the slices. The default is 0.
+        """
+        self.ct = ct
+        self.filename = Path(filename)
+        self.transfer_syntax = transfer_syntax
+        self.section = section
+        self.shape: Optional[tuple] = None
+        self.dtype: Optional[np.dtype] = None
+        self.num_slices = 0
+
+        self.filename.parent.mkdir(parents=True, exist_ok=True)
+        fd, spool = tempfile.mkstemp(suffix=".slices", dir=self.filename.parent)
+        self._spool_name = spool
+        self._spool = os.fdopen(fd, "wb")
+
+    def __enter__(self) -> "CTStreamWriter":
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback) -> None:
+        if exc_type is None:
+            self.close()
+        else:
+            self.abort()
+
+    def append(self, data) -> None:
+        """Append a slice to the section. The slice is spooled to disk, not yet encoded.
+
+        Parameters
+        ----------
+        data : numpy.ndarray|Array2D
+            A 2D slice of shape (height, width). All slices must have the shape
+            and data type of the first one.
+        """
+        if self._spool is None:
+            raise RuntimeError(f"The stream writer of {self.filename} is closed")
+
+        data = np.asarray(data)
+        if data.ndim != 2:
+            raise ValueError("Slices must be 2D")
+        if self.shape is None:
+            self.shape, self.dtype = data.shape, data.dtype
+        elif data.shape != self.shape or data.dtype != self.dtype:
+            raise ValueError(
+                f"Expected a {self.dtype} slice of shape {self.shape}, got {data.dtype} {data.shape}"
+            )
+
+        self._spool.write(memoryview(np.ascontiguousarray(data)).cast("B"))
+        self._spool.flush()
+        self.num_slices += 1
+
+    def close(self) -> None:
+        """Write the CT file from all the appended slices at once and remove the spool file.
+
+        Raises
+        ------
+        RuntimeError
+            If no slice was appended or writing the DICOS file fails.
+        """
+        if self._spool is None:
+            return
+        self._spool.close()
+        self._spool = None
+
+        try:
+            if self.num_slices == 0:
+                raise RuntimeError(f"No slice was appended to {self.filename}")
+
+            slices = np.memmap(
+                self._spool_name, dtype=self.dtype, mode="r+", shape=(self.num_slices,) + self.shape
+            )
+            if self.ct.GetNumberOfSections() <= self.section:
+                self.ct.SetNumberOfSections(self.section + 1)
+            volume = self.ct.GetSectionByIndex(self.section).GetPixelData()
+            keep_alive = volume.set_data(volume, slices, False)
+
+            _err = ErrorLog()
+            written = self.ct.Write(Filename(str(self.filename)), _err, self.transfer_syntax)
+
+            # The volume points into the spool file, detach it before the file goes away
+            volume.FreeMemory()
+            del keep_alive, slices
+            if not written:
+                raise RuntimeError(
+                    f"Failed to write DICOS file: {self.filename}\n{_err.GetErrorLog().Get()}"
+                )
+        finally:
+            os.remove(self._spool_name)
+
+    def abort(self) -> None:
+        """Discard the appended slices without writing the CT file."""
+        if self._spool is not None:
+            self._spool.close()
+            self._spool = None
+            os.remove(self._spool_name)
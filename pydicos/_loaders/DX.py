@@ -1,15 +1,22 @@
+import warnings
 import numpy as np
 from pathlib import Path
-from pyDICOS import DX, ErrorLog, Filename, Volume
+from pyDICOS import DX, ErrorLog, Filename, Volume, probe_pixel_data
 from typing import Optional, Union
 
 from .TDR import TDRLoader
+from .LazyVolume import is_uncompressed, map_pixel_data
 
 
 # This class can be utilized to load a DX object by either reading a DX file or using a provided DX object.
 # The 'get_data' function returns 2D NumPy array.
 class DXLoader(DX):
-    def __init__(self, filename: Optional[Union[str, Path]] = None) -> None:
+    def __init__(
+        self,
+        filename: Optional[Union[str, Path]] = None,
+        metadata_only: bool = False,
+        mmap: bool = False,
+    ) -> None:
         """Initialize the DXLoader class.
 
         Parameters
@@ -17,26 +24,66 @@ class DXLoader(DX):
         filename : str|Path, optional
             The name of the file to read.
             The default is None and will create an empty DX.
+        metadata_only : bool, optional
+            If True, the pixel data of the file is not decoded.
+            The default is False.
+        mmap : bool, optional
+            If True, `get_data` returns a read-only view mapping the file when possible.
+            The default is False.
         """
         super().__init__()
+        self._file_data = None
+        self._pixel_data_skipped = False
+        self.pixel_data_decoded = False
 
         if filename is not None:
-            self.read(filename)
+            self.read(filename, metadata_only, mmap)
 
-    def read(self, filename: Union[str, Path]) -> None:
+    def read(
+        self, filename: Union[str, Path], metadata_only: bool = False, mmap: bool = False
+    ) -> None:
         """Reads the object from a file.
 
         Parameters
         ----------
         filename : str|Path
             The name of the file to read.
+        metadata_only : bool, optional
+            If True, parsing stops at the pixel data: UIDs, dates, geometry and
+            the other attributes are read but no image data is decoded. If the file
+            cannot be cut at its pixel data it is read whole, with a warning, and
+            `pixel_data_decoded` is set. Otherwise the object cannot be written.
+            The default is False.
+        mmap : bool, optional
+            If True and the file is uncompressed, the attributes are read now and `get_data`
+            returns a read-only view mapping the pixel data of the file, shared through the
+            page cache. Compressed files are decoded as usual.
+            The default is False.
         """
+        pixel_data = None
+        if mmap and not metadata_only:
+            # A single header scan decides between mapping the file and decoding it whole
+            pixel_data = probe_pixel_data(str(filename))
+            if not is_uncompressed(pixel_data) or pixel_data["shape"][0] != 1:
+                mmap = False
+
         _err = ErrorLog()
-        if not self.Read(Filename(str(filename)), _err, None):
+        if metadata_only or mmap:
+            _ok, self.pixel_data_decoded = self.read_metadata(Filename(str(filename)), _err, None)
+            if _ok and metadata_only and self.pixel_data_decoded:
+                warnings.warn(f"Read all of {filename}, its pixel data could not be skipped")
+        else:
+            _ok, self.pixel_data_decoded = self.Read(Filename(str(filename)), _err, None), True
+        if not _ok:
             raise RuntimeError(
             f"Failed to read DICOS file: {filename}\n{_err.GetErrorLog().Get()}"
         )
 
+        self._pixel_data_skipped = metadata_only and not self.pixel_data_decoded
+        self._file_data = None
+        if mmap and not metadata_only and not self.pixel_data_decoded:
+            self._file_data = map_pixel_data(filename, pixel_data)[0]
+
     def write(self, filename: Union[str, Path]) -> None:
         """Writes the object to a file.
 
@@ -44,44 +91,82 @@ class DXLoader(DX):
         ----------
         filename : str|Path
             The name of the file to write.
+
+        Raises
+        ------
+        RuntimeError
+            If the object was read with `metadata_only` and holds no pixel data, or the write fails.
+
+        Notes
+        -----
+        The image of a mapped file is copied into the object first, and stays in memory.
         """
+        if self._pixel_data_skipped:
+            raise RuntimeError(f"Cannot write {filename}: the pixel data was not read (metadata_only=True)")
+        if self._file_data is not None:
+            # Mapped pixels are only in _file_data, the image of the object is empty
+            self.set_data(self._file_data)
         _err = ErrorLog()
         if not self.Write(Filename(str(filename)), _err):
             raise RuntimeError(
             f"Failed to write DICOS file: {filename}\n{_err.GetErrorLog().Get()}"
         )
 
-    def get_data(self) -> np.ndarray:
+    def get_data(self, copy: bool = False, rescale: bool = False, out: Optional[np.ndarray] = None) -> np.ndarray:
         """Get the data from the DX object.
 
+        Parameters
+        ----------
+        copy : bool, optional
+            If False (default), the array is a view sharing the memory of this object.
+            If True, the data is copied. Ignored when rescale is True.
+        rescale : bool, optional
+            If True, return the data rescaled with the stored rescale slope and intercept
+            as a float32 array. The default is False.
+        out : numpy.ndarray, optional
+            A C-contiguous float32 array of shape (height, width) receiving the rescaled data.
+            Only used when rescale is True. The default is None and allocates a new array.
+
         Returns
         -------
         data_array : numpy.ndarray
-            A 2D NumPy array.
+            A 2D NumPy array of shape (height, width) with the image data type,
+            or float32 when rescale is True. For mapped files, the view is read-only.
         """
+        if self._file_data is not None:
+            if rescale:
+                if out is None:
+                    out = np.empty(self._file_data.shape, dtype=np.float32)
+                elif out.dtype != np.float32:
+                    raise ValueError("Output array must have float32 data type.")
+                elif out.shape != self._file_data.shape:
+                    raise ValueError("Output array must have the (height, width) shape of the image.")
+                elif not out.flags.c_contiguous or not out.flags.writeable:
+                    raise ValueError("Output array must be C-contiguous and writeable.")
+                np.multiply(self._file_data, self.GetRescaleSlope(), out=out, casting="unsafe")
+                out += self.GetRescaleIntercept()
+                return out
+            return np.array(self._file_data) if copy else self._file_data
+
         imgPixelData = self.GetXRayData()
-        vIndexData = imgPixelData.GetUnsigned16()
-        return np.array(vIndexData, copy=False)
-    
+        if rescale:
+            return imgPixelData.get_rescaled_data(self.GetRescaleSlope(), self.GetRescaleIntercept(), out)
+        return imgPixelData.get_data(copy)
+
     def set_data(self, data: np.ndarray) -> None:
         """Set the data in the DX object.
 
         Parameters
         ----------
         data : numpy.ndarray
-            A 2D NumPy array.
+            A 2D NumPy array of shape (height, width) and any supported data type.
         """
         assert data.ndim == 2, "Data must be 2D"
-        assert data.dtype == np.uint16, "Data must be uint16"
-        width, height = data.shape
+        self._pixel_data_skipped = False
+        self._file_data = None
 
         dxData = self.GetXRayData()
-        dxData.Allocate(Volume.IMAGE_DATA_TYPE.enumUnsigned16Bit, height, width)
-        rawData = dxData.GetUnsigned16()
-
-        for row in range(height):
-            for col in range(width):
-                rawData.Set(row, col, data[col, row])
+        dxData.set_data(dxData, data)
 
     # Note: This function is not implemented in the Stratovan Toolkit yet.
     def generate_tdr(self, detection_boxes: list, output_file: str = None) -> TDRLoader:
@@ -0,0 +1,161 @@
+import numpy as np
+from pathlib import Path
+from pyDICOS import probe_pixel_data
+from typing import Callable, Optional, Union
+
+
+# Transfer syntaxes whose pixel data is stored on disk in native little endian layout
+UNCOMPRESSED_TRANSFER_SYNTAXES = ("1.2.840.10008.1.2", "1.2.840.10008.1.2.1")
+
+
+def is_uncompressed(pixel_data: Optional[dict]) -> bool:
+    """True if the pixel data probed by `probe_pixel_data` can be used in place."""
+    if pixel_data is None or pixel_data["encapsulated"] or pixel_data["samples_per_pixel"] != 1:
+        return False
+    if pixel_data["transfer_syntax"] not in UNCOMPRESSED_TRANSFER_SYNTAXES:
+        return False
+    return pixel_data["length"] >= int(np.prod(pixel_data["shape"])) * pixel_data["dtype"].itemsize
+
+
+def map_pixel_data(filename: Union[str, Path], pixel_data: Optional[dict] = None) -> Optional[np.ndarray]:
+    """Map the pixel data of an uncompressed file in memory.
+
+    Parameters
+    ----------
+    filename : str|Path
+        The name of the file to map.
+    pixel_data : dict, optional
+        The output of `probe_pixel_data` for the file.
+        The default is None and will probe the file.
+
+    Returns
+    -------
+    data_array : numpy.ndarray
+        A read-only (frames, rows, columns) view over the pixel data element of the file,
+        backed by the page cache, or None if the pixel data has to be decoded.
+    """
+    if pixel_data is None:
+        pixel_data = probe_pixel_data(str(filename))
+    if not is_uncompressed(pixel_data):
+        return None
+    mapped = np.memmap(
+        str(filename),
+        dtype=pixel_data["dtype"],
+        mode="r",
+        offset=pixel_data["offset"],
+        shape=tuple(pixel_data["shape"]),
+    )
+    return mapped.view(np.ndarray)
+
+
+# NumPy-like volume that only decodes the frames it is indexed with.
+# Frames of uncompressed files are read straight from the pixel data element of the file.
+# Other transfer syntaxes are decoded all at once on first access.
+# Decoded frames are cached, indexing returns views on the cache.
+class LazyVolume:
+    def __init__(
+        self,
+        filename: Union[str, Path],
+        decode: Optional[Callable[[], np.ndarray]] = None,
+        pixel_data: Optional[dict] = None,
+    ) -> None:
+        """Initialize the LazyVolume class.
+
+        Parameters
+        ----------
+        filename : str|Path
+            The name of the file holding the pixel data.
+        decode : callable, optional
+            Returns the whole (frames, rows, columns) volume, used when the frames
+            cannot be read directly from the file. Required unless the file is uncompressed.
+        pixel_data : dict, optional
+            The output of `probe_pixel_data` for the file.
+            The default is None and will probe the file.
+        """
+        self.filename = str(filename)
+        self._decode = decode
+        self._pixel_data = pixel_data if pixel_data is not None else probe_pixel_data(self.filename)
+        self._cache: Optional[np.ndarray] = None
+        self._loaded: Optional[np.ndarray] = None
+
+        if self._pixel_data is not None and self._pixel_data["samples_per_pixel"] != 1:
+            self._pixel_data = None
+        if self._pixel_data is None:
+            self._decode_all()
+
+    @property
+    def is_direct(self) -> bool:
+        """True if the frames are read straight from the file, without decoding."""
+        return is_uncompressed(self._pixel_data)
+
+    @property
+    def shape(self) -> tuple:
+        return self._cache.shape if self._pixel_data is None else tuple(self._pixel_data["shape"])
+
+    @property
+    def dtype(self) -> np.dtype:
+        return self._cache.dtype if self._pixel_data is None else self._pixel_data["dtype"]
+
+    @property
+    def ndim(self) -> int:
+        return 3
+
+    def __len__(self) -> int:
+        return self.shape[0]
+
+    def __getitem__(self, key):
+        zkey = key[0] if isinstance(key, tuple) and len(key) > 0 else key
+        if zkey is Ellipsis or (isinstance(key, tuple) and len(key) == 0):
+            zkey = slice(None)
+        self._load(np.arange(len(self))[zkey])
+        return self._cache[key]
+
+    def __array__(self, dtype=None, copy=None):
+        # Without a copy the array is a view on the cache, which later loads write into
+        data = self[:]
+        if copy:
+            return np.array(data, dtype=dtype, copy=True)
+        if dtype is not None and np.dtype(dtype) != data.dtype:
+            if copy is False:
+                raise ValueError(f"Converting the {data.dtype} LazyVolume to {np.dtype(dtype)} requires a copy")
+            return data.astype(dtype)
+        return data
+
+    def _allocate(self) -> None:
+        if self._cache is None:
+            # Pages of frames that are never loaded are never touched
+            self._cache = np.empty(self.shape, dtype=self.dtype)
+            self._loaded = np.zeros(len(self), dtype=bool)
+
+    def _decode_all(self) -> None:
+        if self._decode is None:
+            raise ValueError(f"The pixel data of {self.filename} must be decoded, but no decoder was given")
+        data = np.asarray(self._decode())
+        if self._pixel_data is not None and data.shape != self.shape:
+            # The decoder knows better than the header scan
+            self._pixel_data = None
+        self._cache = data
+        self._loaded = np.ones(len(data), dtype=bool)
+
+    def _load(self, frames: np.ndarray) -> None:
+        if not self.is_direct:
+            if self._cache is None:
+                self._decode_all()
+            return
+
+        self._allocate()
+        frames = np.unique(np.atleast_1d(frames))
+        missing = frames[~self._loaded[frames]]
+        if missing.size == 0:
+            return
+
+        # Read each run of consecutive missing frames with a single call
+        frame_bytes = self._cache[0].nbytes
+        runs = np.split(missing, np.flatnonzero(np.diff(missing) != 1) + 1)
+        with open(self.filename, "rb") as file:
+            for run in runs:
+                z0, z1 = int(run[0]), int(run[-1]) + 1
+                file.seek(self._pixel_data["offset"] + z0 * frame_bytes)
+                if file.readinto(memoryview(self._cache[z0:z1]).cast("B")) != (z1 - z0) * frame_bytes:
+                    raise RuntimeError(f"Truncated pixel data in {self.filename}")
+                self._loaded[z0:z1] = True
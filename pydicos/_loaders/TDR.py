@@ -1,3 +1,4 @@
+import warnings
 import numpy as np
 from pathlib import Path
 from pyDICOS import (
@@ -6,7 +7,6 @@ from pyDICOS import (
     Array1DPoint3Dfloat,
     Array1DS_UINT16,
     Bitmap,
-    MemoryBuffer,
     DcsLongString,
     DcsLongText,
     DcsUniqueIdentifier,
@@ -33,7 +33,9 @@ from .ATR import ATRSettings
 
 # This class can be utilized to load a TDR object by either reading a TDR file or using a provided TDR object.
 class TDRLoader(TDR):
-    def __init__(self, filename: Optional[Union[str, Path]] = None) -> None:
+    def __init__(
+        self, filename: Optional[Union[str, Path]] = None, metadata_only: bool = False
+    ) -> None:
         """Initialize the TDRLoader class.
 
         Parameters
@@ -41,22 +43,38 @@ class TDRLoader(TDR):
         filename : str|Path, optional
             The name of the file to read.
             The default is None and will create an empty TDR.
+        metadata_only : bool, optional
+            If True, the pixel data of the file is not decoded.
+            The default is False.
         """
         super().__init__()
+        self.pixel_data_decoded = False
 
         if filename is not None:
-            self.read(filename)
+            self.read(filename, metadata_only)
 
-    def read(self, filename: Union[str, Path]) -> None:
+    def read(self, filename: Union[str, Path], metadata_only: bool = False) -> None:
         """Reads the object from a file.
 
         Parameters
         ----------
         filename : str|Path
             The name of the file to read.
+        metadata_only : bool, optional
+            If True, parsing stops at the pixel data: UIDs, dates, geometry and
+            the other attributes are read but no image data is decoded. If the file
+            cannot be cut at its pixel data it is read whole, with a warning, and
+            `pixel_data_decoded` is set.
+            The default is False.
         """
         _err = ErrorLog()
-        if not self.Read(Filename(str(filename)), _err, None):
+        if metadata_only:
+            _ok, self.pixel_data_decoded = self.read_metadata(Filename(str(filename)), _err, None)
+            if _ok and metadata_only and self.pixel_data_decoded:
+                warnings.warn(f"Read all of {filename}, its pixel data could not be skipped")
+        else:
+            _ok, self.pixel_data_decoded = self.Read(Filename(str(filename)), _err, None), True
+        if not _ok:
             raise RuntimeError(
             f"Failed to read DICOS file: {filename}\n{_err.GetErrorLog().Get()}"
         )
@@ -152,10 +170,7 @@ class TDRLoader(TDR):
             self.GetThreatBoundingPolygon(PTOIds[i], polygon, 0)
 
             if bitmap.GetSize() != 0:
-                byte_array = np.frombuffer(bitmap.GetBitmap(), dtype=np.uint8)
-                bit_array = np.unpackbits(byte_array, bitorder="little")[:bitmap.GetNumBits()]
-                assert bit_array.shape[0] == bitmap.GetDepth()*bitmap.GetHeight()*bitmap.GetWidth(), "Failed to unpack bitmap"
-                bit_array = bit_array.reshape(bitmap.GetDepth(), bitmap.GetHeight(), bitmap.GetWidth())
+                bit_array = bitmap.to_numpy()
             else: 
                 bit_array = np.zeros((int(PTOExtent.z), int(PTOExtent.y), int(PTOExtent.x)), dtype=np.uint16)
             data["PTOs"].append(
@@ -297,12 +312,7 @@ class TDRLoader(TDR):
                     assert pto["Bitmap"].ndim == 3, "Bitmap must be a 3D numpy array"
                     assert pto["Bitmap"].shape == (pto["Extent"]["z"], pto["Extent"]["y"], pto["Extent"]["x"]), "Bitmap shape must match the extent"
                     if pto["Bitmap"].sum() != 0:
-                        threat_bitmap.SetDims(pto["Bitmap"].shape[0], pto["Bitmap"].shape[1], pto["Bitmap"].shape[2], True)
-                        flat_bitmap = pto["Bitmap"].astype(np.uint8).ravel()
-                        byte_array = np.packbits(flat_bitmap, bitorder="little")
-                        byte_buffer = MemoryBuffer()
-                        byte_buffer.SetBuffer(byte_array.tobytes(), byte_array.size)
-                        threat_bitmap.SetBitmapData(byte_buffer, True)
+                        threat_bitmap = Bitmap.from_numpy(pto["Bitmap"])
                         assert threat_bitmap.GetNumBits() == pto["Bitmap"].size, "Failed to set bitmap"
 
                 self.SetThreatRegionOfInterest(
@@ -1,4 +1,7 @@
 from .ATR import ATRSettings
 from .TDR import TDRLoader, TDR_DATA_TEMPLATE
 from .CT import CTLoader
-from .DX import DXLoader
\ No newline at end of file
+from .CTStreamWriter import CTStreamWriter
+from .CTSliceReader import CTSliceReader
+from .DX import DXLoader
+from .LazyVolume import LazyVolume, map_pixel_data
\ No newline at end of file
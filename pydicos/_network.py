@@ -0,0 +1,44 @@
+import asyncio
+from pyDICOS import QueuedReceiveCallback
+from typing import AsyncIterator
+
+
+async def areceive(
+    callback: QueuedReceiveCallback,
+    timeout: float = 0.1,
+) -> AsyncIterator[dict]:
+    """Asynchronously iterate over the objects received by a DICOS server.
+
+    The server threads only push onto the native queue of the callback. The
+    queue is polled without blocking from the event loop, sleeping between
+    polls while it is empty, so the event loop is never blocked and an object
+    is only taken off the queue when it is yielded: cancelling the iteration
+    never loses one, it stays queued for the next consumer.
+
+    Parameters
+    ----------
+    callback : QueuedReceiveCallback
+        The callback given to `DcsServer.StartListening`, e.g. an `IngestReceiveCallback`.
+    timeout : float, optional
+        The longest sleep, in seconds, between two polls of an empty queue. Sleeps
+        start at a millisecond and double up to it. The default is 0.1.
+
+    Yields
+    ------
+    received : dict
+        The "modality" ("CT", "DX" or "TDR"), the "data" object owned by the caller,
+        the "client_ip", "server_ip" and "server_port" of the connection, and the
+        "filename" it was written to, empty if it was not.
+        The iteration ends once the callback is closed and its queue drained.
+    """
+    delay = min(0.001, timeout)
+    while True:
+        received = callback.get_nowait()
+        if received is not None:
+            delay = min(0.001, timeout)
+            yield received
+        elif callback.IsDrained():
+            return
+        else:
+            await asyncio.sleep(delay)
+            delay = min(delay * 2, timeout)
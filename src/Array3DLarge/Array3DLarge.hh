@@ -3,6 +3,7 @@
 
 #include "../headers.hh"
 #include "SDICOS/Array3DLarge.h"
+#include "../ImageDataType/ImageDataType.hh"
 
 using namespace SDICOS;
 
@@ -45,8 +46,23 @@ void export_Array3DLarge(py::module &m,  const std::string & typestr){
         .def("GetWidth", &Array3DLarge<T>::GetWidth)
         .def("GetHeight", &Array3DLarge<T>::GetHeight)
         .def("GetDepth", &Array3DLarge<T>::GetDepth)
-        .def_buffer([](Array3DLarge<T> &m) -> py::buffer_info {  
-            return py::buffer_info(m.GetBuffer(), 
+        .def("IsContiguous", &AreSlicesContiguous<T>)
+        .def("slices", [](py::object self) {
+            Array3DLarge<T> &array = self.cast<Array3DLarge<T>&>();
+            py::list slices;
+            for (S_UINT32 z = 0; z < array.GetDepth(); z++) {
+                slices.append(py::cast(array.GetSlice(z), py::return_value_policy::reference_internal, self));
+            }
+            return slices;
+        }, "Get the slices as a list of 2D arrays referencing the volume memory")
+        .def_buffer([](Array3DLarge<T> &m) -> py::buffer_info {
+            if (!AreSlicesContiguous(m)) {
+                // The slices were allocated separately, expose a read-only gathered copy instead of invalid strides
+                py::buffer_info info = Array3DLargeToNumpy(m, py::handle(), true).request();
+                info.readonly = true;
+                return info;
+            }
+            return py::buffer_info(m.GetDepth() > 0 ? m.GetSlice(0)->GetBuffer() : m.GetBuffer(), 
                                    sizeof(T), 
                                    py::format_descriptor<T>::format(), 
                                    3, 
@@ -2,9 +2,120 @@
 #include <pybind11/pybind11.h>
 #include "SDICOS/Bitmap.h"
 
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 namespace py = pybind11;
 using namespace SDICOS;
 
+// Packs one bit per source byte (nonzero -> 1) in little bit order, as np.packbits(bitorder="little") does
+void pack_bits(const uint8_t* pSource, uint8_t* pDest, const size_t nBits)
+{
+    size_t n = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i zero = _mm_setzero_si128();
+    for (; n + 16 <= nBits; n += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + n));
+        const uint16_t nMask = static_cast<uint16_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero)));
+        std::memcpy(pDest + n / 8, &nMask, sizeof(nMask));
+    }
+#endif
+    for (; n + 8 <= nBits; n += 8) {
+        uint64_t nBytes;
+        std::memcpy(&nBytes, pSource + n, sizeof(nBytes));
+        // Set the high bit of every nonzero byte, then gather the eight high bits into one byte
+        nBytes = (((nBytes & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | nBytes) & 0x8080808080808080ULL;
+        pDest[n / 8] = static_cast<uint8_t>(((nBytes >> 7) * 0x0102040810204080ULL) >> 56);
+    }
+    if (n < nBits) {
+        uint8_t nLast = 0;
+        for (size_t i = 0; n + i < nBits; i++) {
+            nLast |= static_cast<uint8_t>(pSource[n + i] != 0) << i;
+        }
+        pDest[n / 8] = nLast;
+    }
+}
+
+// Expands nBits bits stored in little bit order into one 0/1 byte per bit, as np.unpackbits(bitorder="little") does
+void unpack_bits(const uint8_t* pSource, uint8_t* pDest, const size_t nBits)
+{
+    size_t n = 0;
+    for (; n + 8 <= nBits; n += 8) {
+        // Broadcast the byte, keep bit i in byte i, then turn every nonzero byte into 1
+        uint64_t nBytes = (pSource[n / 8] * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+        nBytes = ((nBytes + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+        std::memcpy(pDest + n, &nBytes, sizeof(nBytes));
+    }
+    for (; n < nBits; n++) {
+        pDest[n] = (pSource[n / 8] >> (n % 8)) & 1;
+    }
+}
+
+// Creates a bitmap from a (depth, height, width) NumPy array, where nonzero values are set bits.
+// The bits are packed straight into the bitmap memory with the GIL released.
+std::unique_ptr<Bitmap> bitmap_from_numpy(py::array array) {
+
+    if (array.ndim() < 1 || array.ndim() > 3) {
+        throw std::invalid_argument("Input array must have one, two or three dimensions.");
+    }
+
+    const char kind = array.dtype().kind();
+    if (kind != 'b' && !(array.itemsize() == 1 && (kind == 'u' || kind == 'i'))) {
+        array = array.attr("astype")("bool");
+    }
+    array = py::array::ensure(array, py::array::c_style);
+
+    const py::ssize_t nDims = array.ndim();
+    const S_UINT64 nWidth = array.shape(nDims - 1);
+    const S_UINT64 nHeight = nDims > 1 ? array.shape(nDims - 2) : 1;
+    const S_UINT64 nDepth = nDims > 2 ? array.shape(nDims - 3) : 1;
+    const size_t nBits = size_t(array.size());
+
+    std::unique_ptr<Bitmap> bitmap(new Bitmap());
+    bitmap->SetDims(nWidth, nHeight, nDepth, true);
+
+    MemoryBuffer &buffer = bitmap->GetBitmap();
+    const size_t nPackedSize = (nBits + 7) / 8;
+    if (buffer.GetSize() < nPackedSize) {
+        throw std::runtime_error("Failed to allocate the bitmap.");
+    }
+
+    const uint8_t* pSource = static_cast<const uint8_t*>(array.data());
+    uint8_t* pDest = buffer.GetData();
+    {
+        py::gil_scoped_release release;
+        pack_bits(pSource, pDest, nBits);
+        std::memset(pDest + nPackedSize, 0, buffer.GetSize() - nPackedSize);
+    }
+    return bitmap;
+}
+
+// Returns the bitmap as a (depth, height, width) uint8 NumPy array of zeros and ones
+py::array_t<uint8_t> bitmap_to_numpy(const Bitmap &bitmap) {
+
+    const size_t nBits = size_t(bitmap.GetNumBits());
+    const std::vector<py::ssize_t> shape = { py::ssize_t(bitmap.GetDepth()), 
+                                             py::ssize_t(bitmap.GetHeight()), 
+                                             py::ssize_t(bitmap.GetWidth()) };
+    if (nBits != size_t(shape[0] * shape[1] * shape[2])) {
+        throw std::runtime_error("The number of bits does not match the bitmap dimensions.");
+    }
+
+    py::array_t<uint8_t> result(shape);
+    const uint8_t* pSource = bitmap.GetBitmap().GetData();
+    uint8_t* pDest = result.mutable_data();
+    {
+        py::gil_scoped_release release;
+        unpack_bits(pSource, pDest, nBits);
+    }
+    return result;
+}
+
 void export_BITMAP(py::module &m)
 {
     py::class_<Bitmap>(m, "Bitmap")
@@ -41,7 +152,9 @@ void export_BITMAP(py::module &m)
         .def("GetNumBits", &Bitmap::GetNumBits) 
         .def("GetWidth", &Bitmap::GetWidth) 
         .def("GetHeight", &Bitmap::GetHeight)
-        .def("GetDepth", &Bitmap::GetDepth);
+        .def("GetDepth", &Bitmap::GetDepth)
+        .def_static("from_numpy", &bitmap_from_numpy, "Create a bitmap from a (depth, height, width) NumPy array", py::arg("data"))
+        .def("to_numpy", &bitmap_to_numpy, "Get the bitmap as a (depth, height, width) uint8 NumPy array");
 
 }
 
@@ -1,4 +1,6 @@
 #include "../headers.hh"
+#include "../GilAwareOverride/GilAwareOverride.hh"
+#include "../DicosIO/DicosHeader.hh"
 
 
  #include "SDICOS/UserCT.h"
@@ -13,35 +15,37 @@
  #include "SDICOS/ImageBaseUser.h"
  #include "SDICOS/XRayEquipmentUser.h"
  #include "SDICOS/FrameOfReferenceUser.h"
+
+#include "../ImageDataType/ImageDataType.hh"
  
 using namespace SDICOS;
 
 PYBIND11_MAKE_OPAQUE(std::vector<CTModule*>);
 
-class PyCT : public CT {
+class PyCT : public GilAwareOverride<CT> {
 public:
-    using CT::CT;
-    void FreeMemory() override { PYBIND11_OVERRIDE(void,  CT, FreeMemory); }
+    using GilAwareOverride<CT>::GilAwareOverride;
+    void FreeMemory() override { PYDICOS_OVERRIDE(void,  CT, FreeMemory); }
 
     bool Read(const DicosFileListing::SopInstance& sopinstance, 
               Array1D< std::pair<Filename, ErrorLog> > &vErrorlogs, 
               IMemoryManager *pMemMgr) 
-              override {PYBIND11_OVERRIDE(bool,  CT, Read, sopinstance, vErrorlogs, pMemMgr);}
+              override {PYDICOS_OVERRIDE(bool,  CT, Read, sopinstance, vErrorlogs, pMemMgr);}
 
     bool Read(const Filename &filename, ErrorLog& errorLog, IMemoryManager *pMemMgr)
-              override {PYBIND11_OVERRIDE(bool,  CT, Read, filename, errorLog, pMemMgr);}  
+              override {PYDICOS_OVERRIDE(bool,  CT, Read, filename, errorLog, pMemMgr);}  
     
     bool Read(MemoryFile &memfile, ErrorLog& errorLog, IMemoryManager *pMemMgr)
-              override {PYBIND11_OVERRIDE(bool,  CT, Read, memfile, errorLog, pMemMgr);}  
+              override {PYDICOS_OVERRIDE(bool,  CT, Read, memfile, errorLog, pMemMgr);}  
 
     bool Write(const Filename &filename, ErrorLog& errorLog, const DicosFile::TRANSFER_SYNTAX nTransferSyntax) const
-              override {PYBIND11_OVERRIDE(bool,  CT, Write, filename, errorLog, nTransferSyntax);}  
+              override {PYDICOS_OVERRIDE(bool,  CT, Write, filename, errorLog, nTransferSyntax);}  
 
     bool Write(const Filename &filenameBase, Array1D< std::pair<Filename, ErrorLog> > &vErrorlogs, const DicosFile::TRANSFER_SYNTAX nTransferSyntax) const
-              override {PYBIND11_OVERRIDE(bool,  CT, Write, filenameBase, vErrorlogs, nTransferSyntax);}  
+              override {PYDICOS_OVERRIDE(bool,  CT, Write, filenameBase, vErrorlogs, nTransferSyntax);}  
   
     bool Write(MemoryFile &memfile, ErrorLog& errorLog, const DicosFile::TRANSFER_SYNTAX nTransferSyntax) const
-              override {PYBIND11_OVERRIDE(bool,  CT, Write, memfile, errorLog, nTransferSyntax);}  
+              override {PYDICOS_OVERRIDE(bool,  CT, Write, memfile, errorLog, nTransferSyntax);}  
 
     bool SendOverNetwork(const S_INT32 nPort, 
                          const DcsString &dsIP, 
@@ -50,21 +54,33 @@ public:
                          ErrorLog &errorlog, 
                          const DcsString &dsUserID,
                          const DcsString dsPasscode)
-              override {PYBIND11_OVERRIDE(bool, CT, SendOverNetwork, nPort, dsIP, aeSrcAppName, aeDstAppName, errorlog, dsUserID, dsPasscode);}  
+              override {PYDICOS_OVERRIDE(bool, CT, SendOverNetwork, nPort, dsIP, aeSrcAppName, aeDstAppName, errorlog, dsUserID, dsPasscode);}  
 
     bool SendOverNetwork(SDICOS::Network::DcsClient &dclient, ErrorLog &errorlog)
-              override {PYBIND11_OVERRIDE(bool, CT, SendOverNetwork, dclient, errorlog);}  
+              override {PYDICOS_OVERRIDE(bool, CT, SendOverNetwork, dclient, errorlog);}  
 
     S_UINT32 SendOverNetwork(SDICOS::Network::DcsClientManager &clientManager, ErrorLog &errorlog, std::vector< Network::DcsClientManager::ClientMetrics > &vSendTimes)
-              override {PYBIND11_OVERRIDE(S_UINT32, CT, SendOverNetwork, clientManager, errorlog, vSendTimes);}  
+              override {PYDICOS_OVERRIDE(S_UINT32, CT, SendOverNetwork, clientManager, errorlog, vSendTimes);}  
 
     IODCommon::MODALITY GetModality() const
-              override {PYBIND11_OVERRIDE(IODCommon::MODALITY, CT, GetModality);}  
+              override {PYDICOS_OVERRIDE(IODCommon::MODALITY, CT, GetModality);}  
 
     DcsUniqueIdentifier GetSopClassUID() const
-              override {PYBIND11_OVERRIDE(DcsUniqueIdentifier, CT, GetSopClassUID);}
+              override {PYDICOS_OVERRIDE(DcsUniqueIdentifier, CT, GetSopClassUID);}
 };
 
+// Returns the pixel data of every section as a list of (depth, height, width) NumPy arrays of the section data type.
+// Sections with contiguous slices are returned as views tied to the lifetime of the CT object unless bCopy is set.
+py::list get_sections_data(py::object self, const bool bCopy)
+{
+    CT &ct = self.cast<CT&>();
+    py::list data;
+    for (CT::Iterator it = ct.Begin(); it != ct.End(); ++it) {
+        Section *pSection = *it;
+        data.append(VolumeToNumpy(pSection->GetPixelData(), pSection->GetPixelDataType(), self, bCopy));
+    }
+    return data;
+}
 
 void export_CT(py::module &m)
 {
@@ -242,21 +258,30 @@ void export_CT(py::module &m)
                      (&PyCT::Read), 
                      py::arg("sopinstance"), 
                      py::arg("vErrorlogs"),
-                     py::arg("pMemMgr") = S_NULL)
+                     py::arg("pMemMgr") = S_NULL,
+                     py::call_guard<py::gil_scoped_release>())
         .def("Read", py::overload_cast<const Filename&, 
                                        ErrorLog&, 
                                        IMemoryManager*>
                      (&PyCT::CT::Read),
                      py::arg("filename"), 
                      py::arg("errorlog"),
-                     py::arg("pMemMgr") = S_NULL)
+                     py::arg("pMemMgr") = S_NULL,
+                     py::call_guard<py::gil_scoped_release>())
         .def("Read", py::overload_cast<MemoryFile&, 
                                        ErrorLog& , 
                                        IMemoryManager*>
                      (&PyCT::CT::Read),
                      py::arg("memfile"), 
                      py::arg("errorlog"),
-                     py::arg("pMemMgr") = S_NULL)       
+                     py::arg("pMemMgr") = S_NULL,
+                     py::call_guard<py::gil_scoped_release>())       
+        .def("read_metadata", &py_read_metadata<CT>,
+                     py::arg("filename"), 
+                     py::arg("errorlog"),
+                     py::arg("pMemMgr") = S_NULL,
+                     "Read the file without decoding its pixel data. Returns (read, pixel_data_decoded): "
+                     "pixel_data_decoded is True if the file had to be read whole")
 
         .def("Write", py::overload_cast<const Filename&, 
                                         ErrorLog&, 
@@ -264,21 +289,24 @@ void export_CT(py::module &m)
                      (&PyCT::CT::Write, py::const_), 
                      py::arg("filename"), 
                      py::arg("errorLog"),
-                     py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG)
+                     py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG,
+                     py::call_guard<py::gil_scoped_release>())
         .def("Write", py::overload_cast<const Filename&, 
                                         Array1D< std::pair<Filename, ErrorLog> > &, 
                                         const DicosFile::TRANSFER_SYNTAX>
                      (&PyCT::CT::Write, py::const_),
                      py::arg("filenameBase"), 
                      py::arg("vErrorlogs"),
-                     py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG)
+                     py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG,
+                     py::call_guard<py::gil_scoped_release>())
         .def("Write", py::overload_cast<MemoryFile&, 
                                         ErrorLog&, 
                                         const DicosFile::TRANSFER_SYNTAX>
                      (&PyCT::CT::Write, py::const_),
                      py::arg("memfile"), 
                      py::arg("errorlog"),
-                     py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG)
+                     py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG,
+                     py::call_guard<py::gil_scoped_release>())
         .def("GetModality", py::overload_cast<>(&PyCT::CT::GetModality, py::const_))
 
         .def("SendOverNetwork", py::overload_cast<const S_INT32, 
@@ -295,16 +323,19 @@ void export_CT(py::module &m)
                      py::arg("aeDstAppName"), 
                      py::arg("errorlog"),
                      py::arg("dsUserID") = "",
-                     py::arg("dsPasscode") = "")
+                     py::arg("dsPasscode") = "",
+                     py::call_guard<py::gil_scoped_release>())
         .def("SendOverNetwork", py::overload_cast<SDICOS::Network::DcsClient&, ErrorLog&>
                      (&PyCT::CT::SendOverNetwork), 
                      py::arg("dclient"), 
-                     py::arg("errorlog"))
+                     py::arg("errorlog"),
+                     py::call_guard<py::gil_scoped_release>())
         .def("SendOverNetwork", py::overload_cast<SDICOS::Network::DcsClientManager&, ErrorLog&, std::vector< Network::DcsClientManager::ClientMetrics >&>
                      (&PyCT::CT::SendOverNetwork), 
                      py::arg("clientManager"), 
                      py::arg("errorlog"),
-                     py::arg("vSendTimes"))
+                     py::arg("vSendTimes"),
+                     py::call_guard<py::gil_scoped_release>())
 
         .def("GetModality", py::overload_cast<>(&PyCT::CT::GetModality, py::const_))
         .def("FreeMemory", py::overload_cast<>(&PyCT::CT::FreeMemory))
@@ -533,6 +564,9 @@ void export_CT(py::module &m)
 
         .def("Begin", &CT::Begin)
         .def("End", &CT::End)
+        .def("get_sections_data", &get_sections_data, 
+                                  "Get the pixel data of every section as a list of 3D NumPy arrays", 
+                                  py::arg("copy") = false)
 
         .def("SetOOIID", &IODCommon::SetOOIID, py::arg("strID"))
         .def("GetOOIID", &IODCommon::GetOOIID)
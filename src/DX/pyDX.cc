@@ -1,4 +1,6 @@
 #include "../headers.hh"
+#include "../GilAwareOverride/GilAwareOverride.hh"
+#include "../DicosIO/DicosHeader.hh"
 
 #include "SDICOS/UserDX.h"
 #include "SDICOS/ModuleDX.h"
@@ -24,28 +26,28 @@ using namespace SDICOS;
 PYBIND11_MAKE_OPAQUE(std::vector<DXModule*>);
 
 
-class PyDX : public DX {
+class PyDX : public GilAwareOverride<DX> {
 public:
-    using DX::DX;
-    void FreeMemory() override { PYBIND11_OVERRIDE(void,  DX, FreeMemory); }
+    using GilAwareOverride<DX>::GilAwareOverride;
+    void FreeMemory() override { PYDICOS_OVERRIDE(void,  DX, FreeMemory); }
 
     bool Read(const Filename &filename, ErrorLog& errorLog, IMemoryManager *pMemMgr)
-              override {PYBIND11_OVERRIDE(bool,  DX, Read, filename, errorLog, pMemMgr);}  
+              override {PYDICOS_OVERRIDE(bool,  DX, Read, filename, errorLog, pMemMgr);}  
     
     bool Read(MemoryFile &memfile, ErrorLog& errorLog, IMemoryManager *pMemMgr)
-              override {PYBIND11_OVERRIDE(bool,  DX, Read, memfile, errorLog, pMemMgr);}  
+              override {PYDICOS_OVERRIDE(bool,  DX, Read, memfile, errorLog, pMemMgr);}  
 
     bool Write(const Filename &filename, ErrorLog& errorLog, const DicosFile::TRANSFER_SYNTAX nTransferSyntax) const
-              override {PYBIND11_OVERRIDE(bool,  DX, Write, filename, errorLog, nTransferSyntax);}  
+              override {PYDICOS_OVERRIDE(bool,  DX, Write, filename, errorLog, nTransferSyntax);}  
 
     bool Write(MemoryFile &memfile, ErrorLog& errorLog, const DicosFile::TRANSFER_SYNTAX nTransferSyntax) const
-              override {PYBIND11_OVERRIDE(bool,  DX, Write, memfile, errorLog, nTransferSyntax);}  
+              override {PYDICOS_OVERRIDE(bool,  DX, Write, memfile, errorLog, nTransferSyntax);}  
 
     IODCommon::MODALITY GetModality() const
-              override {PYBIND11_OVERRIDE(IODCommon::MODALITY, DX, GetModality);} 
+              override {PYDICOS_OVERRIDE(IODCommon::MODALITY, DX, GetModality);} 
 
     bool Validate(ErrorLog& errorlog) const
-              override {PYBIND11_OVERRIDE(bool, DX, Validate, errorlog);}
+              override {PYDICOS_OVERRIDE(bool, DX, Validate, errorlog);}
     
 };
 
@@ -128,7 +130,8 @@ void export_DX(py::module &m)
                      (&PyDX::DX::Read),
                      py::arg("filename"), 
                      py::arg("errorlog"),
-                     py::arg("pMemMgr") = S_NULL)
+                     py::arg("pMemMgr") = S_NULL,
+                     py::call_guard<py::gil_scoped_release>())
         .def("Read", py::overload_cast<MemoryFile&, 
                                        ErrorLog& , 
                                        IMemoryManager*
@@ -136,7 +139,14 @@ void export_DX(py::module &m)
                      (&PyDX::DX::Read),
                      py::arg("memfile"), 
                      py::arg("errorlog"),
-                     py::arg("pMemMgr") = S_NULL)       
+                     py::arg("pMemMgr") = S_NULL,
+                     py::call_guard<py::gil_scoped_release>())       
+        .def("read_metadata", &py_read_metadata<DX>,
+                     py::arg("filename"), 
+                     py::arg("errorlog"),
+                     py::arg("pMemMgr") = S_NULL,
+                     "Read the file without decoding its pixel data. Returns (read, pixel_data_decoded): "
+                     "pixel_data_decoded is True if the file had to be read whole")
 
         .def("Write", py::overload_cast<const Filename&, 
                                         ErrorLog&, 
@@ -145,7 +155,8 @@ void export_DX(py::module &m)
                      (&PyDX::DX::Write, py::const_), 
                      py::arg("filename"), 
                      py::arg("errorLog"),
-                     py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG)
+                     py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG,
+                     py::call_guard<py::gil_scoped_release>())
         .def("Write", py::overload_cast<MemoryFile&, 
                                         ErrorLog&, 
                                         const DicosFile::TRANSFER_SYNTAX
@@ -153,7 +164,8 @@ void export_DX(py::module &m)
                      (&PyDX::DX::Write, py::const_),
                      py::arg("memfile"), 
                      py::arg("errorlog"),
-                     py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG)
+                     py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG,
+                     py::call_guard<py::gil_scoped_release>())
         .def("GetModality", py::overload_cast<>(&PyDX::DX::GetModality, py::const_))
         .def("Validate", py::overload_cast<ErrorLog&>(&PyDX::DX::Validate, py::const_), py::arg("errorlog"))
         .def("GetXRayData", py::overload_cast<>(&DX::GetXRayData),
@@ -180,6 +192,10 @@ void export_DX(py::module &m)
                                                       const Vector3D<float>& >(&XRayGenerationUser::SetImageOrientation), 
                                     py::arg("ptRowOrientation"), py::arg("ptColumnOrientation"))
         .def("SetXRayTubeCurrent", &XRayGenerationUser::SetXRayTubeCurrent, py::arg("fCurrent"))
+        .def("SetRescaleSlope", &DX::SetRescaleSlope, py::arg("fSlope"))
+        .def("GetRescaleSlope", &DX::GetRescaleSlope)
+        .def("SetRescaleIntercept", &DX::SetRescaleIntercept, py::arg("fIntercept"))
+        .def("GetRescaleIntercept", &DX::GetRescaleIntercept)
         .def("SetWindowCenterAndWidth", py::overload_cast<const Array1D<float> &, 
                                                           const Array1D<float> &>(&DX::SetWindowCenterAndWidth), 
                                         py::arg("arrayCenter"), py::arg("arrayWidth"))
@@ -0,0 +1,51 @@
+#include "PooledReceiveAllocators.hh"
+
+SharedReceivePool::SharedReceivePool(const std::vector<SlabSizeClass> &vSizeClasses, const bool bHugePages, const bool bNumaLocal)
+	: SlabPoolMemoryManager(vSizeClasses, bHugePages, bNumaLocal), m_nNumReferences(1)
+{
+}
+
+SharedReceivePool::~SharedReceivePool()
+{
+}
+
+bool SharedReceivePool::OnAllocate(MemoryBuffer &mbAllocate, const S_UINT64 nSizeInBytesToAllocate)
+{
+	if (!SlabPoolMemoryManager::OnAllocate(mbAllocate, nSizeInBytesToAllocate))
+		return false;
+	m_nNumReferences.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool SharedReceivePool::OnDeallocate(MemoryBuffer &mbDeallocate)
+{
+	if (!SlabPoolMemoryManager::OnDeallocate(mbDeallocate))
+		return false;
+	Release();
+	return true;
+}
+
+void SharedReceivePool::Release()
+{
+	if (1 == m_nNumReferences.fetch_sub(1, std::memory_order_acq_rel))
+		delete this;
+}
+
+std::vector<SlabSizeClass> PooledReceiveAllocators::DefaultReceiveSizeClasses()
+{
+	return SlabPoolMemoryManager::PowerOfTwoSizeClasses(4 * 1024, 8 * 1024 * 1024);
+}
+
+PooledReceiveAllocators::PooledReceiveAllocators(const S_UINT32 nNumAllocators, const std::vector<SlabSizeClass> &vSizeClasses,
+												 const bool bHugePages, const bool bNumaLocal)
+	: m_pPool(new SharedReceivePool(vSizeClasses, bHugePages, bNumaLocal))
+{
+	m_vAllocators.SetSize(nNumAllocators > 0 ? nNumAllocators : 1);
+	for (S_UINT32 n(0); n < m_vAllocators.GetSize(); ++n)
+		m_vAllocators[n] = m_pPool;
+}
+
+PooledReceiveAllocators::~PooledReceiveAllocators()
+{
+	m_pPool->Release();
+}
@@ -0,0 +1,58 @@
+#ifndef POOLEDRECEIVEALLOCATORS_FILE_H
+#define POOLEDRECEIVEALLOCATORS_FILE_H
+
+#include "SDICOS/DICOS.h" //Header for DICOS
+#include "../MemManager/SlabPoolMemManager.hh"
+
+#include <atomic>
+
+using namespace SDICOS;
+
+//Slab pool behind PooledReceiveAllocators. Received objects keep their buffers after the server
+//and the allocators are gone, so the pool counts one reference for the allocators and one per
+//buffer in use, and deletes itself when the last one is released.
+class SharedReceivePool : public SlabPoolMemoryManager
+{
+public:
+	SharedReceivePool(const std::vector<SlabSizeClass> &vSizeClasses, const bool bHugePages, const bool bNumaLocal);
+
+	virtual bool OnAllocate(MemoryBuffer &mbAllocate, const S_UINT64 nSizeInBytesToAllocate);
+	virtual bool OnDeallocate(MemoryBuffer &mbDeallocate);
+
+	//Drops one reference, deleting the pool if it was the last
+	void Release();
+
+protected:
+	virtual ~SharedReceivePool();
+
+	std::atomic<S_UINT64> m_nNumReferences;
+};
+
+//Allocators for the receive path of a DcsServer, passed to DcsServer::SetCustomAllocators.
+//Every allocator of the set is the same thread-safe slab pool, so the buffers freed by one
+//connection are reused by the others and a warmed up server receives without touching the heap.
+class PooledReceiveAllocators
+{
+public:
+	//Size classes doubling from 4 KiB to 8 MiB, see SlabPoolMemoryManager::PowerOfTwoSizeClasses
+	static std::vector<SlabSizeClass> DefaultReceiveSizeClasses();
+
+	//nNumAllocators is the number of entries of the set handed to the server
+	PooledReceiveAllocators(const S_UINT32 nNumAllocators = 1,
+							const std::vector<SlabSizeClass> &vSizeClasses = DefaultReceiveSizeClasses(),
+							const bool bHugePages = false, const bool bNumaLocal = false);
+	~PooledReceiveAllocators();
+
+	PooledReceiveAllocators(const PooledReceiveAllocators&) = delete;
+	PooledReceiveAllocators& operator=(const PooledReceiveAllocators&) = delete;
+
+	Array1D<IMemoryManager*>& GetAllocators() { return m_vAllocators; }
+
+	//The pool, for its statistics. It outlives the allocators while received objects hold its buffers.
+	SlabPoolMemoryManager& GetPool() { return *m_pPool; }
+
+protected:
+	SharedReceivePool*			m_pPool;
+	Array1D<IMemoryManager*>	m_vAllocators;
+};
+#endif
\ No newline at end of file
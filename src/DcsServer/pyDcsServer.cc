@@ -1,11 +1,23 @@
 #include "../headers.hh"
 
 #include "SDICOS/Host.h"
+#include "PooledReceiveAllocators.hh"
 
 using namespace SDICOS;
 
 void export_DCSSERVER(py::module &m)
 {
+   py::class_<PooledReceiveAllocators>(m, "PooledReceiveAllocators")
+      .def(py::init<const S_UINT32, const std::vector<SlabSizeClass>&, const bool, const bool>(), 
+           py::arg("nNumAllocators") = 1, 
+           py::arg("vSizeClasses") = PooledReceiveAllocators::DefaultReceiveSizeClasses(), 
+           py::arg("bHugePages") = false, 
+           py::arg("bNumaLocal") = false)
+      .def_static("DefaultReceiveSizeClasses", &PooledReceiveAllocators::DefaultReceiveSizeClasses)
+      .def("GetNumberOfAllocators", [](PooledReceiveAllocators &self) { return self.GetAllocators().GetSize(); })
+      .def("GetPool", &PooledReceiveAllocators::GetPool, py::return_value_policy::reference_internal, 
+           "The slab pool, for its statistics. Received objects keep it alive while they hold its buffers");
+
    py::class_<Network::DcsServer, Network::IDcsServer>(m, "DcsServer")
       .def(py::init<>())
       .def("SetReadTimeoutInMilliseconds", &Network::DcsServer::SetReadTimeoutInMilliseconds, py::arg("nTimeoutMilliseconds") = 1000)
@@ -62,6 +74,10 @@ void export_DCSSERVER(py::module &m)
       .def("ResetIncludedSopClassUIDs", &Network::DcsServer::ResetIncludedSopClassUIDs)
       .def("GetListOfSupportedSopClassUIDs", &Network::DcsServer::GetListOfSupportedSopClassUIDs, py::arg("vSopClassUIDs"))
       .def("SetCustomAllocators", &Network::DcsServer::SetCustomAllocators, py::arg("apiAllocators"))
+      .def("SetCustomAllocators", [](Network::DcsServer &self, PooledReceiveAllocators &allocators) {
+               return self.SetCustomAllocators(allocators.GetAllocators());
+           }, py::arg("allocators"), py::keep_alive<1, 2>(), 
+           "Receive into the slab pool of the allocators. The server keeps the allocators alive and received objects keep the pool alive")
       .def("GetErrorLog", &Network::DcsServer::GetErrorLog, py::arg("dsErrorLog"));
 
       
@@ -0,0 +1,277 @@
+#ifndef DICOSHEADER_FILE_H
+#define DICOSHEADER_FILE_H
+
+#include "../headers.hh"
+
+#include "SDICOS/Filename.h"
+#include "SDICOS/ErrorLog.h"
+#include "SDICOS/MemoryBuffer.h"
+#include "SDICOS/MemoryFile.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace SDICOS;
+
+// Minimal reader for DICOM Part 10 element headers.
+// Only walks the stream to find offsets, values are never decoded.
+struct DicosElementHeader
+{
+    std::uint16_t nGroup = 0;
+    std::uint16_t nElement = 0;
+    char szVR[3] = {0, 0, 0};
+    std::uint32_t nLength = 0;
+
+    bool Is(const std::uint16_t nG, const std::uint16_t nE) const { return nG == nGroup && nE == nElement; }
+    bool IsUndefinedLength() const { return 0xFFFFFFFF == nLength; }
+};
+
+inline std::uint16_t read_le_u16(const unsigned char* p) { return std::uint16_t(p[0] | (p[1] << 8)); }
+inline std::uint32_t read_le_u32(const unsigned char* p)
+{
+    return std::uint32_t(p[0]) | (std::uint32_t(p[1]) << 8) | (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+}
+
+inline bool read_element_header(std::istream& in, const bool bExplicitVR, DicosElementHeader& header)
+{
+    unsigned char buffer[8];
+    if (!in.read(reinterpret_cast<char*>(buffer), 8))
+        return false;
+
+    header.nGroup = read_le_u16(buffer);
+    header.nElement = read_le_u16(buffer + 2);
+    header.szVR[0] = header.szVR[1] = 0;
+
+    // Item and delimiter tags never carry a VR
+    if (0xFFFE == header.nGroup || !bExplicitVR) {
+        header.nLength = read_le_u32(buffer + 4);
+        return true;
+    }
+
+    header.szVR[0] = char(buffer[4]);
+    header.szVR[1] = char(buffer[5]);
+    static const char* s_LongVRs[] = {"OB", "OD", "OF", "OL", "OW", "SQ", "UC", "UN", "UR", "UT"};
+    for (const char* szVR : s_LongVRs) {
+        if (0 == std::memcmp(header.szVR, szVR, 2)) {
+            if (!in.read(reinterpret_cast<char*>(buffer), 4))
+                return false;
+            header.nLength = read_le_u32(buffer);
+            return true;
+        }
+    }
+    header.nLength = read_le_u16(buffer + 6);
+    return true;
+}
+
+inline bool skip_element_value(std::istream& in, const bool bExplicitVR, const DicosElementHeader& header);
+
+// Skips the items of an undefined length sequence up to and including the sequence delimiter
+inline bool skip_undefined_sequence(std::istream& in, const bool bExplicitVR)
+{
+    DicosElementHeader item;
+    while (read_element_header(in, bExplicitVR, item)) {
+        if (item.Is(0xFFFE, 0xE0DD))
+            return true;
+        if (!item.Is(0xFFFE, 0xE000))
+            return false;
+        if (!item.IsUndefinedLength()) {
+            if (!in.seekg(item.nLength, std::ios::cur))
+                return false;
+            continue;
+        }
+
+        DicosElementHeader element;
+        bool bItemEnded = false;
+        while (!bItemEnded && read_element_header(in, bExplicitVR, element)) {
+            if (element.Is(0xFFFE, 0xE00D))
+                bItemEnded = true;
+            else if (!skip_element_value(in, bExplicitVR, element))
+                return false;
+        }
+        if (!bItemEnded)
+            return false;
+    }
+    return false;
+}
+
+inline bool skip_element_value(std::istream& in, const bool bExplicitVR, const DicosElementHeader& header)
+{
+    if (header.IsUndefinedLength())
+        return skip_undefined_sequence(in, bExplicitVR);
+    return bool(in.seekg(header.nLength, std::ios::cur));
+}
+
+// Result of scanning a file up to the top-level Pixel Data element (7FE0,0010),
+// or Float/Double Float Pixel Data (7FE0,0008)/(7FE0,0009)
+struct DicosHeaderScan
+{
+    std::string strSopClassUID;         // Media Storage SOP Class UID (0002,0002)
+    std::string strTransferSyntaxUID;   // Transfer Syntax UID (0002,0010)
+    std::int64_t nPixelDataOffset = -1; // Offset of the Pixel Data tag, -1 if not found
+    std::int64_t nPixelDataValueOffset = -1;
+    std::uint32_t nPixelDataLength = 0; // 0xFFFFFFFF for encapsulated pixel data
+    std::uint16_t nPixelDataElement = 0;
+    bool bExplicitVR = true;
+
+    // Image Pixel module, top-level values only
+    std::uint16_t nRows = 0;
+    std::uint16_t nColumns = 0;
+    std::uint32_t nNumberOfFrames = 1;
+    std::uint16_t nBitsAllocated = 0;
+    std::uint16_t nPixelRepresentation = 0;
+    std::uint16_t nSamplesPerPixel = 1;
+
+    bool IsEncapsulated() const { return 0xFFFFFFFF == nPixelDataLength; }
+};
+
+inline std::string read_uid_value(std::istream& in, const std::uint32_t nLength)
+{
+    // UIDs are at most 64 characters
+    if (nLength > 64)
+        return std::string();
+    std::string strUID(nLength, '\0');
+    if (nLength > 0 && !in.read(&strUID[0], nLength))
+        return std::string();
+    while (!strUID.empty() && ('\0' == strUID.back() || ' ' == strUID.back()))
+        strUID.pop_back();
+    return strUID;
+}
+
+inline bool read_us_value(std::istream& in, const std::uint32_t nLength, std::uint16_t& nValue)
+{
+    unsigned char buffer[2];
+    if (2 != nLength || !in.read(reinterpret_cast<char*>(buffer), 2))
+        return false;
+    nValue = read_le_u16(buffer);
+    return true;
+}
+
+inline bool read_is_value(std::istream& in, const std::uint32_t nLength, std::uint32_t& nValue)
+{
+    // IS values are at most 12 characters
+    if (nLength > 12)
+        return false;
+    char buffer[13] = {0};
+    if (!in.read(buffer, nLength))
+        return false;
+    nValue = std::uint32_t(std::strtoul(buffer, S_NULL, 10));
+    return true;
+}
+
+// Reads the file meta header and, if bFindPixelData, walks the dataset to the Pixel Data element.
+// Returns false if the file is not a DICOM Part 10 file.
+inline bool scan_dicos_header(const std::string& strFilename, const bool bFindPixelData, DicosHeaderScan& scan)
+{
+    std::ifstream file(strFilename, std::ios::binary);
+    char preamble[132];
+    if (!file.read(preamble, sizeof(preamble)) || 0 != std::memcmp(preamble + 128, "DICM", 4))
+        return false;
+
+    // The meta header is always Explicit VR Little Endian
+    DicosElementHeader header;
+    std::streamoff nDatasetOffset = file.tellg();
+    while (read_element_header(file, true, header) && 0x0002 == header.nGroup) {
+        if (header.Is(0x0002, 0x0002))
+            scan.strSopClassUID = read_uid_value(file, header.nLength);
+        else if (header.Is(0x0002, 0x0010))
+            scan.strTransferSyntaxUID = read_uid_value(file, header.nLength);
+        else if (!skip_element_value(file, true, header))
+            return false;
+        nDatasetOffset = file.tellg();
+    }
+
+    if (!bFindPixelData)
+        return true;
+
+    // Big endian datasets are left to the SDK
+    if ("1.2.840.10008.1.2.2" == scan.strTransferSyntaxUID)
+        return true;
+    scan.bExplicitVR = "1.2.840.10008.1.2" != scan.strTransferSyntaxUID;
+
+    file.clear();
+    file.seekg(nDatasetOffset);
+    for (std::streamoff nOffset = nDatasetOffset; read_element_header(file, scan.bExplicitVR, header); nOffset = file.tellg()) {
+        bool bRead = true;
+        if (0x7FE0 == header.nGroup && (0x0008 == header.nElement || 0x0009 == header.nElement || 0x0010 == header.nElement)) {
+            scan.nPixelDataOffset = nOffset;
+            scan.nPixelDataValueOffset = file.tellg();
+            scan.nPixelDataLength = header.nLength;
+            scan.nPixelDataElement = header.nElement;
+            break;
+        }
+        else if (header.Is(0x0028, 0x0002))
+            bRead = read_us_value(file, header.nLength, scan.nSamplesPerPixel);
+        else if (header.Is(0x0028, 0x0008))
+            bRead = read_is_value(file, header.nLength, scan.nNumberOfFrames);
+        else if (header.Is(0x0028, 0x0010))
+            bRead = read_us_value(file, header.nLength, scan.nRows);
+        else if (header.Is(0x0028, 0x0011))
+            bRead = read_us_value(file, header.nLength, scan.nColumns);
+        else if (header.Is(0x0028, 0x0100))
+            bRead = read_us_value(file, header.nLength, scan.nBitsAllocated);
+        else if (header.Is(0x0028, 0x0103))
+            bRead = read_us_value(file, header.nLength, scan.nPixelRepresentation);
+        else
+            bRead = skip_element_value(file, scan.bExplicitVR, header);
+
+        if (!bRead)
+            break;
+    }
+    return true;
+}
+
+// Reads the object from the file without its pixel data.
+// The file is cut at the Pixel Data element, which is replaced by an empty one, and read from memory.
+// If the SDK rejects the truncated dataset, or the pixel data cannot be cut, the whole file is read and
+// bPixelDataDecoded is set. It stays false for files without pixel data, where the whole file is the metadata.
+template<typename T>
+bool read_metadata(T& dcs, const Filename& filename, ErrorLog& errorlog, IMemoryManager* pMemMgr, bool& bPixelDataDecoded)
+{
+    const std::string strFilename(filename.GetFullPath().Get());
+    DicosHeaderScan scan;
+    const bool bScanned(scan_dicos_header(strFilename, true, scan));
+    bPixelDataDecoded = false;
+    if (bScanned && scan.nPixelDataOffset > 0 && 0x0010 == scan.nPixelDataElement) {
+        std::vector<unsigned char> vHeader(size_t(scan.nPixelDataOffset));
+        std::ifstream file(strFilename, std::ios::binary);
+        if (file.read(reinterpret_cast<char*>(vHeader.data()), std::streamsize(vHeader.size()))) {
+            static const unsigned char s_ExplicitPixelData[] = {0xE0, 0x7F, 0x10, 0x00, 'O', 'W', 0, 0, 0, 0, 0, 0};
+            static const unsigned char s_ImplicitPixelData[] = {0xE0, 0x7F, 0x10, 0x00, 0, 0, 0, 0};
+            if (scan.bExplicitVR)
+                vHeader.insert(vHeader.end(), std::begin(s_ExplicitPixelData), std::end(s_ExplicitPixelData));
+            else
+                vHeader.insert(vHeader.end(), std::begin(s_ImplicitPixelData), std::end(s_ImplicitPixelData));
+
+            MemoryBuffer membuffer;
+            membuffer.SetBuffer(vHeader.data(), vHeader.size());
+            membuffer.SetMemoryPolicy(MemoryBuffer::MEMORY_POLICY::enumPolicy_DoesNotOwnData);
+            MemoryFile memfile;
+            ErrorLog errorlogHeader;
+            if (memfile.OpenReading(membuffer) && dcs.T::Read(memfile, errorlogHeader, pMemMgr))
+                return true;
+        }
+    }
+
+    bPixelDataDecoded = !bScanned || scan.nPixelDataOffset > 0;
+    return dcs.T::Read(filename, errorlog, pMemMgr);
+}
+
+// Binding of read_metadata, returning (read, pixel data decoded)
+template<typename T>
+py::tuple py_read_metadata(T& dcs, const Filename& filename, ErrorLog& errorlog, IMemoryManager* pMemMgr)
+{
+    bool bRead;
+    bool bPixelDataDecoded(false);
+    {
+        py::gil_scoped_release release;
+        bRead = read_metadata(dcs, filename, errorlog, pMemMgr, bPixelDataDecoded);
+    }
+    return py::make_tuple(bRead, bPixelDataDecoded);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "../headers.hh"
+#include "DicosHeader.hh"
+
+#include "SDICOS/UserCT.h"
+#include "SDICOS/UserDX.h"
+#include "SDICOS/UserTDR.h"
+#include "SDICOS/ErrorLog.h"
+#include "SDICOS/SopClassUID.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace SDICOS;
+
+// One queued read: the target object is resolved while holding the GIL,
+// the read itself runs on a worker thread without it.
+struct ReadTask
+{
+    std::function<bool(const Filename&, ErrorLog&)> read;
+    std::string strFilename;
+    ErrorLog* pErrorLog = S_NULL;
+    bool bResult = false;
+};
+
+static std::function<bool(const Filename&, ErrorLog&)> make_reader(py::handle dcs)
+{
+    // Qualified calls match the "Read" bindings and never re-enter Python
+    if (py::isinstance<CT>(dcs)) {
+        CT* pCT = dcs.cast<CT*>();
+        return [pCT](const Filename& filename, ErrorLog& errorlog) { return pCT->CT::Read(filename, errorlog, S_NULL); };
+    }
+    if (py::isinstance<DX>(dcs)) {
+        DX* pDX = dcs.cast<DX*>();
+        return [pDX](const Filename& filename, ErrorLog& errorlog) { return pDX->DX::Read(filename, errorlog, S_NULL); };
+    }
+    if (py::isinstance<TDR>(dcs)) {
+        TDR* pTDR = dcs.cast<TDR*>();
+        return [pTDR](const Filename& filename, ErrorLog& errorlog) { return pTDR->TDR::Read(filename, errorlog, S_NULL); };
+    }
+    throw py::type_error("read_many expects CT, DX or TDR objects");
+}
+
+// Records an exception that escaped a read in the ErrorLog of its task.
+static void log_read_exception(ReadTask& task, const char* pMessage)
+{
+    try {
+        const std::string strMessage("Exception while reading " + task.strFilename + ": " + pMessage);
+        task.pErrorLog->AddError(DcsString(strMessage.c_str()));
+    } catch (...) {
+        // Out of memory, the failed result is all that can be reported
+    }
+}
+
+static void run_tasks(std::vector<ReadTask>& vTasks, size_t nMaxWorkers)
+{
+    if (0 == nMaxWorkers)
+        nMaxWorkers = std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t nWorkers = std::min(nMaxWorkers, vTasks.size());
+
+    std::atomic<size_t> nNext(0);
+    auto worker = [&]() {
+        for (size_t n = nNext++; n < vTasks.size(); n = nNext++) {
+            ReadTask& task = vTasks[n];
+            try {
+                task.bResult = task.read(Filename(task.strFilename.c_str()), *task.pErrorLog);
+            } catch (const std::exception& e) {
+                task.bResult = false;
+                log_read_exception(task, e.what());
+            } catch (...) {
+                task.bResult = false;
+                log_read_exception(task, "unknown exception");
+            }
+        }
+    };
+
+    std::vector<std::thread> vThreads;
+    vThreads.reserve(nWorkers > 0 ? nWorkers - 1 : 0);
+    for (size_t n = 1; n < nWorkers; ++n)
+        vThreads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : vThreads)
+        thread.join();
+}
+
+py::list read_many(py::sequence items, size_t nMaxWorkers)
+{
+    std::vector<ReadTask> vTasks;
+    vTasks.reserve(py::len(items));
+    std::unordered_set<PyObject*> setObjects;
+    for (py::handle item : items) {
+        py::tuple tItem = item.cast<py::tuple>();
+        if (tItem.size() != 3)
+            throw py::value_error("read_many expects (dcs, filename, errorlog) tuples");
+        // Two workers would read into the same object at once
+        if (!setObjects.insert(tItem[0].ptr()).second)
+            throw py::value_error("read_many got the same dcs object more than once");
+
+        ReadTask task;
+        task.read = make_reader(tItem[0]);
+        task.strFilename = py::str(tItem[1]).cast<std::string>();
+        task.pErrorLog = tItem[2].cast<ErrorLog*>();
+        vTasks.push_back(std::move(task));
+    }
+
+    {
+        py::gil_scoped_release release;
+        run_tasks(vTasks, nMaxWorkers);
+    }
+
+    py::list results;
+    for (const ReadTask& task : vTasks)
+        results.append(task.bResult);
+    return results;
+}
+
+// Reads the Media Storage SOP Class UID (0002,0002) from the file meta header.
+// Only the preamble and group 0x0002 are read, never the dataset itself.
+// Returns an empty string if the file is not a Part 10 file.
+std::string probe_sop_class_uid(const std::string& strFilename)
+{
+    DicosHeaderScan scan;
+    if (!scan_dicos_header(strFilename, false, scan))
+        return std::string();
+    return scan.strSopClassUID;
+}
+
+// "CT", "DX" or "TDR" from the probed SOP Class UID, empty if unknown
+std::string probe_modality(const std::string& strFilename)
+{
+    const std::string strUID = probe_sop_class_uid(strFilename);
+    if (strUID.empty())
+        return std::string();
+
+    const DcsUniqueIdentifier uid(strUID.c_str());
+    if (SOPClassUID::IsCT(uid))
+        return "CT";
+    if (SOPClassUID::IsDX(uid))
+        return "DX";
+    if (SOPClassUID::IsTDR(uid))
+        return "TDR";
+    return std::string();
+}
+
+// Locates the native pixel data of a file for direct access.
+// Returns None if the file has no pixel data element the scanner understands.
+py::object probe_pixel_data(const std::string& strFilename)
+{
+    DicosHeaderScan scan;
+    bool bFound = false;
+    {
+        py::gil_scoped_release release;
+        bFound = scan_dicos_header(strFilename, true, scan) && scan.nPixelDataValueOffset > 0;
+    }
+    if (!bFound)
+        return py::none();
+
+    std::string strDtype;
+    if (0x0008 == scan.nPixelDataElement)
+        strDtype = "<f4";
+    else if (0x0009 == scan.nPixelDataElement)
+        strDtype = "<f8";
+    else if (8 == scan.nBitsAllocated || 16 == scan.nBitsAllocated || 32 == scan.nBitsAllocated || 64 == scan.nBitsAllocated)
+        strDtype = std::string(scan.nPixelRepresentation ? "<i" : "<u") + std::to_string(scan.nBitsAllocated / 8);
+    else
+        return py::none();
+
+    py::dict info;
+    info["transfer_syntax"] = scan.strTransferSyntaxUID;
+    info["offset"] = scan.nPixelDataValueOffset;
+    info["length"] = scan.IsEncapsulated() ? py::object(py::none()) : py::object(py::int_(scan.nPixelDataLength));
+    info["encapsulated"] = scan.IsEncapsulated();
+    info["shape"] = py::make_tuple(scan.nNumberOfFrames, scan.nRows, scan.nColumns);
+    info["samples_per_pixel"] = scan.nSamplesPerPixel;
+    info["dtype"] = py::dtype(strDtype);
+    return info;
+}
+
+void export_DICOSIO(py::module &m)
+{
+    m.def("probe_sop_class_uid", &probe_sop_class_uid,
+          py::arg("filename"),
+          py::call_guard<py::gil_scoped_release>(),
+          "Read the SOP Class UID from the file meta header without parsing the dataset.\n"
+          "Returns an empty string if the file has no DICOM meta header.");
+    m.def("probe_modality", &probe_modality,
+          py::arg("filename"),
+          py::call_guard<py::gil_scoped_release>(),
+          "Return \"CT\", \"DX\" or \"TDR\" from the file meta header, or an empty string if unknown.");
+    m.def("probe_pixel_data", &probe_pixel_data,
+          py::arg("filename"),
+          "Locate the pixel data element of a file without reading it.\n"
+          "Returns a dict with the transfer syntax, the value offset and length, whether the data\n"
+          "is encapsulated, the (frames, rows, columns) shape and the dtype, or None.");
+    m.def("read_many", &read_many,
+          py::arg("items"),
+          py::arg("nMaxWorkers") = 0,
+          "Read a list of (dcs, filename, errorlog) tuples on a pool of native threads.\n"
+          "Each dcs is a CT, DX or TDR that is read in-place; errors go to its own ErrorLog.\n"
+          "Returns the per-item success flags in input order. nMaxWorkers=0 uses one thread per core.");
+}
@@ -0,0 +1,66 @@
+#ifndef GILAWAREOVERRIDE_FILE_H
+#define GILAWAREOVERRIDE_FILE_H
+
+#include "../headers.hh"
+
+#include <mutex>
+#include <unordered_map>
+
+// Base for the trampoline classes of objects whose methods run with the GIL released.
+// PYBIND11_OVERRIDE acquires the GIL on every call just to look for a Python override.
+// This class looks the override up once per method and instance, so the GIL is only
+// acquired again when a Python override really exists.
+template<typename Base>
+class GilAwareOverride : public Base
+{
+public:
+    using Base::Base;
+
+    GilAwareOverride() = default;
+
+    GilAwareOverride(const GilAwareOverride &rhs) : Base(rhs) {}
+
+    GilAwareOverride& operator=(const GilAwareOverride &rhs)
+    {
+        Base::operator=(rhs);
+        return *this;
+    }
+
+protected:
+    // Returns true when the Python type of this object overrides the method szName.
+    // szName is expected to be a string literal, its address is used as the cache key.
+    bool HasPythonOverride(const char *szName) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutexOverrides);
+            auto it = m_mapOverrides.find(szName);
+            if (m_mapOverrides.end() != it) {
+                return it->second;
+            }
+        }
+
+        bool bOverride;
+        {
+            py::gil_scoped_acquire gil;
+            bOverride = static_cast<bool>(py::get_override(static_cast<const Base*>(this), szName));
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutexOverrides);
+        m_mapOverrides[szName] = bOverride;
+        return bOverride;
+    }
+
+private:
+    mutable std::mutex m_mutexOverrides;
+    mutable std::unordered_map<const char*, bool> m_mapOverrides;
+};
+
+// Same as PYBIND11_OVERRIDE, but calls the C++ implementation without touching the GIL
+// when the Python type does not override the method
+#define PYDICOS_OVERRIDE(ret_type, cname, fn, ...)                  \
+    if (!this->HasPythonOverride(#fn)) {                            \
+        return cname::fn(__VA_ARGS__);                              \
+    }                                                               \
+    PYBIND11_OVERRIDE(ret_type, cname, fn, __VA_ARGS__)
+
+#endif
\ No newline at end of file
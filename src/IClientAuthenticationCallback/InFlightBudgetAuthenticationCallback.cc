@@ -0,0 +1,56 @@
+#include "InFlightBudgetAuthenticationCallback.hh"
+
+InFlightBudgetAuthenticationCallback::InFlightBudgetAuthenticationCallback(QueuedReceiveCallback &icallback,
+                                                                           Network::IClientAuthenticationCallback *pAuthenticationCallback,
+                                                                           const S_UINT32 nDelayMilliseconds)
+   : m_pCallback(&icallback), m_pAuthenticationCallback(pAuthenticationCallback), m_nDelayMilliseconds(nDelayMilliseconds)
+{
+}
+
+bool InFlightBudgetAuthenticationCallback::OnAuthenticateUserName(const SDICOS::Utils::AuthenticationData &ad)const
+{
+   return S_NULL == m_pAuthenticationCallback || m_pAuthenticationCallback->AuthenticateUserName(ad);
+}
+
+bool InFlightBudgetAuthenticationCallback::OnAuthenticateUserNameAndPasscode(const SDICOS::Utils::AuthenticationData &ad)const
+{
+   return S_NULL == m_pAuthenticationCallback || m_pAuthenticationCallback->AuthenticateUserNameAndPasscode(ad);
+}
+
+bool InFlightBudgetAuthenticationCallback::OnAuthenticateClientApplicationName(const SDICOS::Utils::AuthenticationData &ad)const
+{
+   //A client refused by the authentication is never held
+   if (S_NULL != m_pAuthenticationCallback && !m_pAuthenticationCallback->AuthenticateClientApplicationName(ad))
+      return false;
+
+   InFlightBudget &budget = m_pCallback->GetInFlightBudget();
+   if (budget.WaitForRoom(m_nDelayMilliseconds))
+      return true;
+
+   budget.OnRejected();
+   return false;
+}
+
+void InFlightBudgetAuthenticationCallback::OnConnectedToClient(const SDICOS::Utils::SessionData &sd)
+{
+   if (S_NULL != m_pAuthenticationCallback)
+      m_pAuthenticationCallback->ConnectedToClient(sd);
+}
+
+void InFlightBudgetAuthenticationCallback::OnDisconnectedFromClient(const SDICOS::Utils::SessionData &sd)
+{
+   if (S_NULL != m_pAuthenticationCallback)
+      m_pAuthenticationCallback->DisconnectedFromClient(sd);
+}
+
+void InFlightBudgetAuthenticationCallback::OnDicosConnectionStarted(const SDICOS::Utils::SessionData &sd)
+{
+   if (S_NULL != m_pAuthenticationCallback)
+      m_pAuthenticationCallback->DicosConnectionStarted(sd);
+}
+
+void InFlightBudgetAuthenticationCallback::OnDicosConnectionStopped(const SDICOS::Utils::SessionData &sd)
+{
+   if (S_NULL != m_pAuthenticationCallback)
+      m_pAuthenticationCallback->DicosConnectionStopped(sd);
+}
@@ -0,0 +1,38 @@
+#ifndef INFLIGHTBUDGETAUTHENTICATIONCALLBACK_FILE_H
+#define INFLIGHTBUDGETAUTHENTICATIONCALLBACK_FILE_H
+
+#include "SDICOS/DICOS.h" 
+#include "../IReceiveCallback/QueuedReceiveCallback.hh"
+
+using namespace SDICOS;
+
+// Refuses new associations while the receive pipeline of a QueuedReceiveCallback is over its in-flight budget.
+// An association arriving over budget is held for up to nDelayMilliseconds, then rejected if the consumers did
+// not catch up. Clients can retry later. Applies when the server requires application names
+// (DcsServer::RequireApplicationNames), since the server then authenticates each association with this callback.
+// Every check is first delegated to pAuthenticationCallback, if any, so the budget comes on top of the
+// authentication of the server rather than replacing it.
+class InFlightBudgetAuthenticationCallback : public Network::IClientAuthenticationCallback
+{
+public:
+   InFlightBudgetAuthenticationCallback(QueuedReceiveCallback &icallback,
+                                        Network::IClientAuthenticationCallback *pAuthenticationCallback = S_NULL,
+                                        const S_UINT32 nDelayMilliseconds = 1000);
+
+   S_UINT32 GetDelayMilliseconds() const { return m_nDelayMilliseconds; }
+
+protected:
+   virtual bool OnAuthenticateUserName(const SDICOS::Utils::AuthenticationData &ad)const;
+   virtual bool OnAuthenticateUserNameAndPasscode(const SDICOS::Utils::AuthenticationData &ad)const;
+   virtual bool OnAuthenticateClientApplicationName(const SDICOS::Utils::AuthenticationData &ad)const;
+   virtual void OnConnectedToClient(const SDICOS::Utils::SessionData &sd);
+   virtual void OnDisconnectedFromClient(const SDICOS::Utils::SessionData &sd);
+   virtual void OnDicosConnectionStarted(const SDICOS::Utils::SessionData &sd);
+   virtual void OnDicosConnectionStopped(const SDICOS::Utils::SessionData &sd);
+
+   QueuedReceiveCallback*                   m_pCallback;
+   Network::IClientAuthenticationCallback*  m_pAuthenticationCallback;
+   const S_UINT32                           m_nDelayMilliseconds;
+};
+
+#endif
\ No newline at end of file
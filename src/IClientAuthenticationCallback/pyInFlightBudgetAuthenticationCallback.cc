@@ -0,0 +1,19 @@
+#include "../headers.hh"
+#include "SDICOS/IClientAuthentication.h"
+#include "InFlightBudgetAuthenticationCallback.hh"
+
+using namespace SDICOS;
+using namespace Network;
+
+
+void export_InFlightBudgetAuthenticationCallback(py::module &m)
+{
+   py::class_<InFlightBudgetAuthenticationCallback, Network::IClientAuthenticationCallback>(m, "InFlightBudgetAuthenticationCallback")
+      .def(py::init<QueuedReceiveCallback&, Network::IClientAuthenticationCallback*, const S_UINT32>(),
+           py::arg("icallback"),
+           py::arg("pAuthenticationCallback") = S_NULL,
+           py::arg("nDelayMilliseconds") = 1000,
+           py::keep_alive<1, 2>(),
+           py::keep_alive<1, 3>())
+      .def("GetDelayMilliseconds", &InFlightBudgetAuthenticationCallback::GetDelayMilliseconds);
+}
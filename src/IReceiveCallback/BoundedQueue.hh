@@ -0,0 +1,107 @@
+#ifndef BOUNDEDQUEUE_FILE_H
+#define BOUNDEDQUEUE_FILE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free queue for several producers and several consumers.
+// Each cell carries a sequence number telling whether it is ready to be written or read,
+// so TryPush and TryPop are one compare-and-swap on the shared position and never block.
+// The capacity is rounded up to a power of two.
+template<typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(const std::size_t nCapacity)
+        : m_nMask(RoundUpToPowerOfTwo(nCapacity) - 1), m_pCells(new Cell[m_nMask + 1]),
+          m_nEnqueuePos(0), m_nDequeuePos(0)
+    {
+        for (std::size_t n(0); n <= m_nMask; ++n)
+            m_pCells[n].m_nSequence.store(n, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Returns false, leaving data untouched, when the queue is full
+    bool TryPush(T &data)
+    {
+        std::size_t nPos(m_nEnqueuePos.load(std::memory_order_relaxed));
+        for (;;) {
+            Cell &cell(m_pCells[nPos & m_nMask]);
+            const std::size_t nSequence(cell.m_nSequence.load(std::memory_order_acquire));
+            const std::ptrdiff_t nDiff(std::ptrdiff_t(nSequence) - std::ptrdiff_t(nPos));
+            if (0 == nDiff) {
+                if (m_nEnqueuePos.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed)) {
+                    cell.m_data = std::move(data);
+                    cell.m_nSequence.store(nPos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (nDiff < 0) {
+                return false;
+            }
+            else {
+                nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns false when the queue is empty
+    bool TryPop(T &data)
+    {
+        std::size_t nPos(m_nDequeuePos.load(std::memory_order_relaxed));
+        for (;;) {
+            Cell &cell(m_pCells[nPos & m_nMask]);
+            const std::size_t nSequence(cell.m_nSequence.load(std::memory_order_acquire));
+            const std::ptrdiff_t nDiff(std::ptrdiff_t(nSequence) - std::ptrdiff_t(nPos + 1));
+            if (0 == nDiff) {
+                if (m_nDequeuePos.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed)) {
+                    data = std::move(cell.m_data);
+                    cell.m_nSequence.store(nPos + m_nMask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (nDiff < 0) {
+                return false;
+            }
+            else {
+                nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::size_t GetCapacity() const { return m_nMask + 1; }
+
+    // Number of queued items, exact when no push or pop is running
+    std::size_t GetSize() const
+    {
+        const std::size_t nDequeuePos(m_nDequeuePos.load(std::memory_order_relaxed));
+        const std::size_t nEnqueuePos(m_nEnqueuePos.load(std::memory_order_relaxed));
+        return nEnqueuePos > nDequeuePos ? nEnqueuePos - nDequeuePos : 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> m_nSequence;
+        T m_data;
+    };
+
+    static std::size_t RoundUpToPowerOfTwo(const std::size_t nValue)
+    {
+        std::size_t nPowerOfTwo(2);
+        while (nPowerOfTwo < nValue)
+            nPowerOfTwo <<= 1;
+        return nPowerOfTwo;
+    }
+
+    const std::size_t                   m_nMask;
+    std::unique_ptr<Cell[]>             m_pCells;
+    alignas(64) std::atomic<std::size_t> m_nEnqueuePos; //Producers and consumers on separate cache lines
+    alignas(64) std::atomic<std::size_t> m_nDequeuePos;
+};
+
+#endif
\ No newline at end of file
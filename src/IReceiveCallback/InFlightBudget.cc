@@ -0,0 +1,147 @@
+#include "InFlightBudget.hh"
+
+#include <chrono>
+
+InFlightBudget::InFlightBudget(const S_UINT64 nMaxBytes, const S_UINT64 nMaxObjects)
+    : m_nMaxBytes(nMaxBytes), m_nMaxObjects(nMaxObjects), m_nBytesInFlight(0), m_nObjectsInFlight(0),
+      m_nHighWaterBytes(0), m_nNumDelayed(0), m_nNumRejected(0), m_nNumWaiting(0)
+{
+}
+
+void InFlightBudget::SetLimits(const S_UINT64 nMaxBytes, const S_UINT64 nMaxObjects)
+{
+    m_nMaxBytes.store(nMaxBytes, std::memory_order_relaxed);
+    m_nMaxObjects.store(nMaxObjects, std::memory_order_relaxed);
+
+    //Raised limits may let the waiting threads go
+    std::lock_guard<std::mutex> lock(m_mutexWait);
+    m_cvRoom.notify_all();
+}
+
+bool InFlightBudget::TryAcquire(const S_UINT64 nSizeInBytes)
+{
+    bool bRolledBack(false);
+    const bool bAcquired(TryReserve(nSizeInBytes, bRolledBack));
+    if (bRolledBack)
+        Notify();
+    return bAcquired;
+}
+
+bool InFlightBudget::TryReserve(const S_UINT64 nSizeInBytes, bool &bRolledBack)
+{
+    //Each counter is reserved with a CAS, so concurrent server threads cannot overshoot a limit together
+    const S_UINT64 nMaxObjects(GetMaxObjects());
+    S_UINT64 nObjects(m_nObjectsInFlight.load(std::memory_order_relaxed));
+    do {
+        if (nMaxObjects > 0 && nObjects >= nMaxObjects)
+            return false;
+    } while (!m_nObjectsInFlight.compare_exchange_weak(nObjects, nObjects + 1, std::memory_order_relaxed));
+
+    const S_UINT64 nMaxBytes(GetMaxBytes());
+    S_UINT64 nBytes(m_nBytesInFlight.load(std::memory_order_relaxed));
+    do {
+        if (nMaxBytes > 0 && nBytes > 0 && nBytes + nSizeInBytes > nMaxBytes) {
+            m_nObjectsInFlight.fetch_sub(1, std::memory_order_relaxed);
+            bRolledBack = true;
+            return false;
+        }
+    } while (!m_nBytesInFlight.compare_exchange_weak(nBytes, nBytes + nSizeInBytes, std::memory_order_relaxed));
+
+    nBytes += nSizeInBytes;
+    S_UINT64 nHighWater(m_nHighWaterBytes.load(std::memory_order_relaxed));
+    while (nHighWater < nBytes &&
+           !m_nHighWaterBytes.compare_exchange_weak(nHighWater, nBytes, std::memory_order_relaxed)) {}
+    return true;
+}
+
+bool InFlightBudget::Acquire(const S_UINT64 nSizeInBytes, const S_UINT32 nTimeoutMilliseconds)
+{
+    if (TryAcquire(nSizeInBytes))
+        return true;
+
+    m_nNumDelayed.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lock(m_mutexWait);
+    m_nNumWaiting.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst); //Pairs with the fence of Notify
+    const bool bAcquired(m_cvRoom.wait_for(lock, std::chrono::milliseconds(nTimeoutMilliseconds), [&]() {
+        bool bRolledBack(false);
+        const bool bReserved(TryReserve(nSizeInBytes, bRolledBack));
+        if (bRolledBack)
+            m_cvRoom.notify_all(); //The mutex is already held
+        return bReserved;
+    }));
+    m_nNumWaiting.fetch_sub(1, std::memory_order_relaxed);
+    return bAcquired;
+}
+
+void InFlightBudget::Release(const S_UINT64 nSizeInBytes)
+{
+    m_nObjectsInFlight.fetch_sub(1, std::memory_order_relaxed);
+    m_nBytesInFlight.fetch_sub(nSizeInBytes, std::memory_order_relaxed);
+    Notify();
+}
+
+void InFlightBudget::Notify()
+{
+    //Same handshake as ReceivedQueue: either this thread sees the waiting thread, or it sees the release
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_nNumWaiting.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(m_mutexWait);
+        m_cvRoom.notify_all();
+    }
+}
+
+bool InFlightBudget::HasRoom() const
+{
+    const S_UINT64 nMaxBytes(GetMaxBytes());
+    const S_UINT64 nMaxObjects(GetMaxObjects());
+    return (0 == nMaxBytes || GetBytesInFlight() < nMaxBytes) &&
+           (0 == nMaxObjects || GetObjectsInFlight() < nMaxObjects);
+}
+
+bool InFlightBudget::WaitForRoom(const S_UINT32 nTimeoutMilliseconds)
+{
+    if (HasRoom())
+        return true;
+
+    m_nNumDelayed.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lock(m_mutexWait);
+    m_nNumWaiting.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst); //Pairs with the fence of Release
+    const bool bRoom(m_cvRoom.wait_for(lock, std::chrono::milliseconds(nTimeoutMilliseconds), [this]() { return HasRoom(); }));
+    m_nNumWaiting.fetch_sub(1, std::memory_order_relaxed);
+    return bRoom;
+}
+
+S_UINT64 InFlightBudget::EstimateSizeInBytes(CT &ct)
+{
+    S_UINT64 nSizeInBytes(0);
+    for (CT::Iterator it = ct.Begin(); it != ct.End(); ++it)
+        nSizeInBytes += (*it)->GetPixelData().GetSizeInBytes();
+    return nSizeInBytes;
+}
+
+S_UINT64 InFlightBudget::EstimateSizeInBytes(DX &dx)
+{
+    const Image2D &image = dx.GetXRayData();
+    S_UINT64 nBytesPerPixel(0);
+    switch (image.GetImageDataType()) {
+        case ImageDataBase::enumSigned8Bit:
+        case ImageDataBase::enumUnsigned8Bit:   nBytesPerPixel = 1; break;
+        case ImageDataBase::enumSigned16Bit:
+        case ImageDataBase::enumUnsigned16Bit:  nBytesPerPixel = 2; break;
+        case ImageDataBase::enumSigned32Bit:
+        case ImageDataBase::enumUnsigned32Bit:
+        case ImageDataBase::enumFloat:          nBytesPerPixel = 4; break;
+        case ImageDataBase::enumSigned64Bit:
+        case ImageDataBase::enumUnsigned64Bit:  nBytesPerPixel = 8; break;
+        default: break;
+    }
+    return S_UINT64(image.GetWidth()) * image.GetHeight() * nBytesPerPixel;
+}
+
+S_UINT64 InFlightBudget::EstimateSizeInBytes(TDR &tdr)
+{
+    //Threat reports carry no pixel data of their own, only the object counts
+    return 0;
+}
@@ -0,0 +1,83 @@
+#ifndef INFLIGHTBUDGET_FILE_H
+#define INFLIGHTBUDGET_FILE_H
+
+#include "SDICOS/DICOS.h" 
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+using namespace SDICOS;
+
+// Bytes and objects received by a server and not yet handed over or deleted by the receive pipeline.
+// An object enters the pipeline only once its bytes are reserved (TryAcquire, Acquire), so the limits are
+// never exceeded; the one exception is an object larger than the byte limit, let in when nothing else is
+// in flight so it cannot be starved. HasRoom tells whether new associations should be accepted.
+// A limit of 0 means no limit.
+class InFlightBudget
+{
+public:
+    InFlightBudget(const S_UINT64 nMaxBytes = 0, const S_UINT64 nMaxObjects = 0);
+
+    InFlightBudget(const InFlightBudget&) = delete;
+    InFlightBudget& operator=(const InFlightBudget&) = delete;
+
+    void SetLimits(const S_UINT64 nMaxBytes, const S_UINT64 nMaxObjects);
+    S_UINT64 GetMaxBytes() const { return m_nMaxBytes.load(std::memory_order_relaxed); }
+    S_UINT64 GetMaxObjects() const { return m_nMaxObjects.load(std::memory_order_relaxed); }
+    bool IsLimited() const { return GetMaxBytes() > 0 || GetMaxObjects() > 0; }
+
+    // Reserves room for an object entering the pipeline. Returns false, reserving nothing, if it does not fit.
+    bool TryAcquire(const S_UINT64 nSizeInBytes);
+
+    // Waits up to nTimeoutMilliseconds for room for the object. Waits that had to sleep are counted as delays.
+    bool Acquire(const S_UINT64 nSizeInBytes, const S_UINT32 nTimeoutMilliseconds);
+
+    // Gives back the room of an object leaving the pipeline
+    void Release(const S_UINT64 nSizeInBytes);
+
+    // True while both the bytes and the objects in flight are under their limits
+    bool HasRoom() const;
+
+    // Waits up to nTimeoutMilliseconds for the pipeline to get under its limits.
+    // Returns HasRoom(). Waits that had to sleep are counted as delays.
+    bool WaitForRoom(const S_UINT32 nTimeoutMilliseconds);
+
+    // Counts an object or an association refused because the pipeline is over budget
+    void OnRejected() { m_nNumRejected.fetch_add(1, std::memory_order_relaxed); }
+
+    S_UINT64 GetBytesInFlight() const { return m_nBytesInFlight.load(std::memory_order_relaxed); }
+    S_UINT64 GetObjectsInFlight() const { return m_nObjectsInFlight.load(std::memory_order_relaxed); }
+    S_UINT64 GetHighWaterBytes() const { return m_nHighWaterBytes.load(std::memory_order_relaxed); }
+    S_UINT64 GetNumberDelayed() const { return m_nNumDelayed.load(std::memory_order_relaxed); }
+    S_UINT64 GetNumberRejected() const { return m_nNumRejected.load(std::memory_order_relaxed); }
+
+    // Bytes of the pixel data of a received object, which dominate the memory it holds.
+    // A TDR has no pixel data: it is 0 bytes and only counts against the object limit.
+    static S_UINT64 EstimateSizeInBytes(CT &ct);
+    static S_UINT64 EstimateSizeInBytes(DX &dx);
+    static S_UINT64 EstimateSizeInBytes(TDR &tdr);
+
+protected:
+    // Reserves the object and its bytes. bRolledBack is set if the object was reserved, then given back
+    // because its bytes did not fit: a thread that saw it meanwhile may be waiting and must be woken up.
+    bool TryReserve(const S_UINT64 nSizeInBytes, bool &bRolledBack);
+
+    // Wakes up the threads waiting for room
+    void Notify();
+
+    std::atomic<S_UINT64>   m_nMaxBytes;
+    std::atomic<S_UINT64>   m_nMaxObjects;
+    std::atomic<S_UINT64>   m_nBytesInFlight;
+    std::atomic<S_UINT64>   m_nObjectsInFlight;
+    std::atomic<S_UINT64>   m_nHighWaterBytes;
+    std::atomic<S_UINT64>   m_nNumDelayed;
+    std::atomic<S_UINT64>   m_nNumRejected;
+
+    // Only used to put the waiting threads to sleep
+    std::mutex              m_mutexWait;
+    std::condition_variable m_cvRoom;
+    std::atomic<S_UINT32>   m_nNumWaiting;
+};
+
+#endif
\ No newline at end of file
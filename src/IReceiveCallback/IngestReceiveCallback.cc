@@ -0,0 +1,177 @@
+#include "IngestReceiveCallback.hh"
+
+#include <chrono>
+#include <cstdio>
+
+IngestReceiveCallback::IngestReceiveCallback(const S_UINT32 nNumWorkers,
+                                             const std::string &strOutputFolder,
+                                             const bool bHandToPython,
+                                             const S_UINT32 nCapacity,
+                                             const S_UINT32 nOutputCapacity,
+                                             const DicosFile::TRANSFER_SYNTAX nTransferSyntax)
+    : QueuedReceiveCallback(nCapacity), m_strOutputFolder(strOutputFolder), m_bHandToPython(bHandToPython),
+      m_nTransferSyntax(nTransferSyntax), m_outputQueue(nOutputCapacity), m_nNumInProgress(0),
+      m_nNumWritten(0), m_nNumWriteErrors(0), m_nFileIndex(0), m_nNumRunning(0)
+{
+    //Nothing would ever leave the input queue without a worker
+    const S_UINT32 nWorkers(nNumWorkers > 0 ? nNumWorkers : 1);
+    m_nNumRunning.store(nWorkers, std::memory_order_relaxed);
+    m_vWorkers.reserve(nWorkers);
+    for (S_UINT32 n(0); n < nWorkers; ++n)
+        m_vWorkers.emplace_back(&IngestReceiveCallback::RunWorker, this);
+}
+
+IngestReceiveCallback::~IngestReceiveCallback()
+{
+    //Closing the output queue too keeps workers from waiting on consumers that are gone
+    m_queue.Close();
+    m_outputQueue.Close();
+    for (std::vector<std::thread>::iterator it = m_vWorkers.begin(); it != m_vWorkers.end(); ++it)
+        it->join();
+}
+
+void IngestReceiveCallback::RunWorker()
+{
+    ReceivedDicos received;
+    for (;;) {
+        if (!m_queue.Pop(received, 100)) {
+            if (m_queue.IsDrained())
+                break;
+            continue;
+        }
+
+        m_nNumInProgress.fetch_add(1, std::memory_order_relaxed);
+        if (!m_strOutputFolder.empty())
+            Write(received);
+
+        if (m_bHandToPython) {
+            //Waiting here is what pushes back on the input queue
+            while (!m_outputQueue.Push(received, 100)) {
+                if (m_outputQueue.IsClosed()) {
+                    LeavePipeline(received);
+                    OnDropped(received, "consumers gone");
+                    break;
+                }
+            }
+        }
+        else {
+            LeavePipeline(received);
+            received.Release();
+        }
+        m_nNumInProgress.fetch_sub(1, std::memory_order_relaxed);
+        received = ReceivedDicos();
+    }
+
+    if (1 == m_nNumRunning.fetch_sub(1, std::memory_order_acq_rel))
+        m_outputQueue.Close();
+}
+
+bool IngestReceiveCallback::Write(ReceivedDicos &received)
+{
+    const char* pModality(S_NULL);
+    switch (received.m_nModality) {
+        case ReceivedDicos::enumCT: pModality = "CT"; break;
+        case ReceivedDicos::enumDX: pModality = "DX"; break;
+        case ReceivedDicos::enumTDR: pModality = "TDR"; break;
+        default: return false;
+    }
+
+    ErrorLog errorlog;
+    std::string strFilename;
+    if (!ClaimFilename(received, pModality, strFilename)) {
+        OnWriteError(strFilename, pModality, errorlog);
+        return false;
+    }
+
+    bool bWritten(false);
+    switch (received.m_nModality) {
+        case ReceivedDicos::enumCT: bWritten = received.m_pCT->Write(Filename(strFilename.c_str()), errorlog, m_nTransferSyntax); break;
+        case ReceivedDicos::enumDX: bWritten = received.m_pDX->Write(Filename(strFilename.c_str()), errorlog, m_nTransferSyntax); break;
+        case ReceivedDicos::enumTDR: bWritten = received.m_pTDR->Write(Filename(strFilename.c_str()), errorlog, m_nTransferSyntax); break;
+        default: break;
+    }
+
+    if (!bWritten) {
+        std::remove(strFilename.c_str());
+        OnWriteError(strFilename, pModality, errorlog);
+        return false;
+    }
+    m_nNumWritten.fetch_add(1, std::memory_order_relaxed);
+    received.m_strFilename = strFilename;
+    return true;
+}
+
+bool IngestReceiveCallback::ClaimFilename(const ReceivedDicos &received, const char *pModality, std::string &strFilename)
+{
+    std::string strName;
+    switch (received.m_nModality) {
+        case ReceivedDicos::enumCT: strName = received.m_pCT->GetSopInstanceUID().Get(); break;
+        case ReceivedDicos::enumDX: strName = received.m_pDX->GetSopInstanceUID().Get(); break;
+        case ReceivedDicos::enumTDR: strName = received.m_pTDR->GetSopInstanceUID().Get(); break;
+        default: break;
+    }
+    if (strName.empty()) {
+        char vName[48];
+        std::snprintf(vName, sizeof(vName), "%llu_%llu",
+                      static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch()).count()),
+                      static_cast<unsigned long long>(m_nFileIndex.fetch_add(1, std::memory_order_relaxed)));
+        strName = vName;
+    }
+
+    //The same object sent twice gets a suffix rather than replacing the first file
+    const std::string strPrefix(m_strOutputFolder + "/" + pModality + "_" + strName);
+    for (S_UINT32 n(0); n < 1000; ++n) {
+        strFilename = 0 == n ? strPrefix + ".dcs" : strPrefix + "_" + std::to_string(n) + ".dcs";
+        //"x" fails if the file exists, so two workers cannot claim the same name
+        if (std::FILE *pFile = std::fopen(strFilename.c_str(), "wx")) {
+            std::fclose(pFile);
+            return true;
+        }
+    }
+    return false;
+}
+
+void IngestReceiveCallback::OnWriteError(const std::string &strFilename, const char *pModality, const ErrorLog &errorlog)
+{
+    m_nNumWriteErrors.fetch_add(1, std::memory_order_relaxed);
+
+    WriteError error;
+    error.m_strFilename = strFilename;
+    error.m_strModality = pModality;
+    error.m_errorlog = errorlog;
+
+    std::lock_guard<std::mutex> lock(m_mutexWriteErrors);
+    m_dqWriteErrors.push_back(error);
+    if (m_dqWriteErrors.size() > nMaxWriteErrors)
+        m_dqWriteErrors.pop_front();
+}
+
+std::vector<IngestReceiveCallback::WriteError> IngestReceiveCallback::GetWriteErrors() const
+{
+    std::lock_guard<std::mutex> lock(m_mutexWriteErrors);
+    return std::vector<WriteError>(m_dqWriteErrors.begin(), m_dqWriteErrors.end());
+}
+
+bool IngestReceiveCallback::TryPop(ReceivedDicos &received)
+{
+    if (!m_outputQueue.TryPop(received))
+        return false;
+
+    LeavePipeline(received);
+    return true;
+}
+
+bool IngestReceiveCallback::Pop(ReceivedDicos &received, const S_UINT32 nTimeoutMilliseconds)
+{
+    if (!m_outputQueue.Pop(received, nTimeoutMilliseconds))
+        return false;
+
+    LeavePipeline(received);
+    return true;
+}
+
+void IngestReceiveCallback::Close()
+{
+    m_queue.Close();
+}
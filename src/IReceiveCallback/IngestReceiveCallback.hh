@@ -0,0 +1,99 @@
+#ifndef INGESTRECEIVECALLBACK_FILE_H
+#define INGESTRECEIVECALLBACK_FILE_H
+
+#include "SDICOS/DICOS.h" 
+#include "QueuedReceiveCallback.hh"
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace SDICOS;
+
+// Receive callback fanning the received CT, DX and TDR out to a pool of worker threads.
+// The server thread only queues the object (see QueuedReceiveCallback). Each worker pops it,
+// writes it to the output folder if one is set, then either queues it for the consumers
+// or deletes it. Workers wait for room in the output queue, so a slow consumer fills the
+// input queue and later objects are dropped there, never on the server thread.
+// Files are named after the SOP Instance UID of the object and existing files are never overwritten.
+class IngestReceiveCallback : public QueuedReceiveCallback
+{
+public:
+    // With an empty strOutputFolder nothing is written. With bHandToPython = false the
+    // objects are deleted once written, and nothing is left for the consumers. Only hand
+    // written objects to Python if something consumes them: otherwise the workers wait on
+    // the output queue and later objects are dropped before they are written.
+    IngestReceiveCallback(const S_UINT32 nNumWorkers = 4,
+                          const std::string &strOutputFolder = "",
+                          const bool bHandToPython = true,
+                          const S_UINT32 nCapacity = 64,
+                          const S_UINT32 nOutputCapacity = 64,
+                          const DicosFile::TRANSFER_SYNTAX nTransferSyntax = DicosFile::enumLosslessJPEG);
+    virtual ~IngestReceiveCallback();
+
+    // The consumers read the objects the workers are done with
+    virtual bool TryPop(ReceivedDicos &received);
+    virtual bool Pop(ReceivedDicos &received, const S_UINT32 nTimeoutMilliseconds);
+
+    // Closes the input queue. The workers finish the objects already queued, and the last
+    // one to stop closes the output queue, so consumers see the end once they drained it.
+    virtual void Close();
+    virtual bool IsDrained() const { return m_outputQueue.IsDrained(); }
+
+    S_UINT32 GetNumberOfWorkers() const { return S_UINT32(m_vWorkers.size()); }
+    const std::string& GetOutputFolder() const { return m_strOutputFolder; }
+    bool IsHandingToPython() const { return m_bHandToPython; }
+
+    // Depth of each stage: queued for the workers, being processed, queued for the consumers
+    S_UINT32 GetNumberInProgress() const { return m_nNumInProgress.load(std::memory_order_relaxed); }
+    S_UINT32 GetOutputCapacity() const { return m_outputQueue.GetCapacity(); }
+    S_UINT32 GetOutputSize() const { return m_outputQueue.GetSize(); }
+    S_UINT32 GetOutputHighWaterSize() const { return m_outputQueue.GetHighWaterSize(); }
+
+    S_UINT64 GetNumberWritten() const { return m_nNumWritten.load(std::memory_order_relaxed); }
+    S_UINT64 GetNumberOfWriteErrors() const { return m_nNumWriteErrors.load(std::memory_order_relaxed); }
+
+    // Write that failed, with the log of the SDK
+    struct WriteError
+    {
+        std::string m_strFilename;
+        std::string m_strModality;
+        ErrorLog    m_errorlog;
+    };
+
+    // Most recent failed writes, oldest first. Only the last nMaxWriteErrors are kept.
+    std::vector<WriteError> GetWriteErrors() const;
+    static const S_UINT32 nMaxWriteErrors = 64;
+
+protected:
+    void RunWorker();
+
+    // Writes the object to the output folder as <modality>_<SOP Instance UID>.dcs
+    bool Write(ReceivedDicos &received);
+
+    // Creates an empty file for the object so that no other write, from this run or an earlier one,
+    // can use its name. Objects without a SOP Instance UID are named after their time of arrival.
+    bool ClaimFilename(const ReceivedDicos &received, const char *pModality, std::string &strFilename);
+
+    void OnWriteError(const std::string &strFilename, const char *pModality, const ErrorLog &errorlog);
+
+    const std::string                   m_strOutputFolder;
+    const bool                          m_bHandToPython;
+    const DicosFile::TRANSFER_SYNTAX    m_nTransferSyntax;
+
+    ReceivedQueue                       m_outputQueue;
+    std::atomic<S_UINT32>               m_nNumInProgress;
+    std::atomic<S_UINT64>               m_nNumWritten;
+    std::atomic<S_UINT64>               m_nNumWriteErrors;
+    std::atomic<S_UINT64>               m_nFileIndex; //Tells apart files claimed in the same millisecond
+    std::atomic<S_UINT32>               m_nNumRunning; //Workers that did not stop yet
+
+    mutable std::mutex                  m_mutexWriteErrors;
+    std::deque<WriteError>              m_dqWriteErrors;
+
+    std::vector<std::thread>            m_vWorkers;
+};
+
+#endif
\ No newline at end of file
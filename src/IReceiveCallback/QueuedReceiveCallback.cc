@@ -0,0 +1,131 @@
+#include "QueuedReceiveCallback.hh"
+
+QueuedReceiveCallback::QueuedReceiveCallback(const S_UINT32 nCapacity)
+    : m_queue(nCapacity), m_nMaxDelayMilliseconds(1000), m_nNumReceived(0), m_nNumDropped(0), m_nNumErrors(0)
+{
+}
+
+QueuedReceiveCallback::~QueuedReceiveCallback()
+{
+}
+
+template<typename T>
+void QueuedReceiveCallback::TakeOwnership(Utils::DicosData<T> &data, T *&pData, ReceivedDicos &received)
+{
+    //If ownership is not taken, the data is deleted when the callback returns
+    data.TakeOwnership(pData);
+    received.m_strClientIP = data.GetClientIP().Get();
+    received.m_strServerIP = data.GetServerIP().Get();
+    received.m_nServerPort = data.GetServerPort();
+    received.m_nSizeInBytes = InFlightBudget::EstimateSizeInBytes(*pData);
+}
+
+void QueuedReceiveCallback::OnReceiveDicosFile(Utils::DicosData<CT> &ct, const ErrorLog &errorlog)
+{
+    ReceivedDicos received;
+    received.m_nModality = ReceivedDicos::enumCT;
+    TakeOwnership(ct, received.m_pCT, received);
+    Push(received);
+}
+
+void QueuedReceiveCallback::OnReceiveDicosFile(Utils::DicosData<DX> &dx, const ErrorLog &errorlog)
+{
+    ReceivedDicos received;
+    received.m_nModality = ReceivedDicos::enumDX;
+    TakeOwnership(dx, received.m_pDX, received);
+    Push(received);
+}
+
+void QueuedReceiveCallback::OnReceiveDicosFile(Utils::DicosData<TDR> &tdr, const ErrorLog &errorlog)
+{
+    ReceivedDicos received;
+    received.m_nModality = ReceivedDicos::enumTDR;
+    TakeOwnership(tdr, received.m_pTDR, received);
+    Push(received);
+}
+
+void QueuedReceiveCallback::OnReceiveDicosFileError(const ErrorLog &errorlog, const Utils::SessionData &sessiondata)
+{
+    m_nNumErrors.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool QueuedReceiveCallback::Push(ReceivedDicos &received)
+{
+    m_nNumReceived.fetch_add(1, std::memory_order_relaxed);
+
+    //Holding the server thread keeps this client from sending more until the consumers catch up
+    if (!m_budget.Acquire(received.m_nSizeInBytes, GetMaxDelayMilliseconds())) {
+        m_budget.OnRejected();
+        OnDropped(received, "over the in-flight budget");
+        return false;
+    }
+
+    if (!m_queue.TryPush(received)) {
+        LeavePipeline(received);
+        OnDropped(received, m_queue.IsClosed() ? "closed" : "queue full");
+        return false;
+    }
+    return true;
+}
+
+void QueuedReceiveCallback::OnDropped(ReceivedDicos &received, const char *pReason)
+{
+    m_nNumDropped.fetch_add(1, std::memory_order_relaxed);
+
+    Drop drop;
+    switch (received.m_nModality) {
+        case ReceivedDicos::enumCT: drop.m_strModality = "CT"; break;
+        case ReceivedDicos::enumDX: drop.m_strModality = "DX"; break;
+        case ReceivedDicos::enumTDR: drop.m_strModality = "TDR"; break;
+        default: break;
+    }
+    drop.m_strClientIP = received.m_strClientIP;
+    drop.m_strReason = pReason;
+    received.Release();
+
+    std::lock_guard<std::mutex> lock(m_mutexDrops);
+    m_dqDrops.push_back(drop);
+    if (m_dqDrops.size() > nMaxDrops)
+        m_dqDrops.pop_front();
+}
+
+std::vector<QueuedReceiveCallback::Drop> QueuedReceiveCallback::GetDrops() const
+{
+    std::lock_guard<std::mutex> lock(m_mutexDrops);
+    return std::vector<Drop>(m_dqDrops.begin(), m_dqDrops.end());
+}
+
+void QueuedReceiveCallback::LeavePipeline(ReceivedDicos &received)
+{
+    m_budget.Release(received.m_nSizeInBytes);
+    received.m_nSizeInBytes = 0;
+}
+
+void QueuedReceiveCallback::SetInFlightBudget(const S_UINT64 nMaxBytes, const S_UINT64 nMaxObjects, const S_UINT32 nMaxDelayMilliseconds)
+{
+    m_nMaxDelayMilliseconds.store(nMaxDelayMilliseconds, std::memory_order_relaxed);
+    m_budget.SetLimits(nMaxBytes, nMaxObjects);
+}
+
+bool QueuedReceiveCallback::TryPop(ReceivedDicos &received)
+{
+    if (!m_queue.TryPop(received))
+        return false;
+
+    LeavePipeline(received);
+    return true;
+}
+
+bool QueuedReceiveCallback::Pop(ReceivedDicos &received, const S_UINT32 nTimeoutMilliseconds)
+{
+    if (!m_queue.Pop(received, nTimeoutMilliseconds))
+        return false;
+
+    LeavePipeline(received);
+    return true;
+}
+
+void QueuedReceiveCallback::Close()
+{
+    m_queue.Close();
+}
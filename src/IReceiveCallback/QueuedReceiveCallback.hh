@@ -0,0 +1,105 @@
+#ifndef QUEUEDRECEIVECALLBACK_FILE_H
+#define QUEUEDRECEIVECALLBACK_FILE_H
+
+#include "SDICOS/DICOS.h" 
+#include "ReceivedQueue.hh"
+#include "InFlightBudget.hh"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace SDICOS;
+
+// Receive callback handing the received CT, DX and TDR over to consumer threads.
+// The server thread takes ownership of each object, pushes it onto a bounded lock-free queue
+// and returns at once: it never waits on a consumer, and never on Python. Objects received
+// while the queue is full or closed are deleted and counted as dropped.
+// With an in-flight budget set, a server thread receiving an object that does not fit in the budget
+// waits up to the maximum delay for room, which slows the client down through TCP. If there is still
+// no room the object is deleted and counted as dropped, so the budget is a hard cap.
+// Every drop is recorded, with the client that sent the object and the reason (see GetDrops).
+class QueuedReceiveCallback : public Network::IReceiveCallback
+{
+public:
+    explicit QueuedReceiveCallback(const S_UINT32 nCapacity = 64);
+    virtual ~QueuedReceiveCallback();
+
+    // Takes the next object for the consumers without waiting. Returns false if there is none.
+    virtual bool TryPop(ReceivedDicos &received);
+
+    // Waits up to nTimeoutMilliseconds for the next object. Returns false on timeout,
+    // or as soon as the callback is closed and drained.
+    virtual bool Pop(ReceivedDicos &received, const S_UINT32 nTimeoutMilliseconds);
+
+    // Queues an object that did not come from the server, e.g. read from a file, as if it had been received.
+    // Takes ownership of it: it is queued, or released if the budget or the queue has no room.
+    bool Put(ReceivedDicos &received) { return Push(received); }
+
+    // Stops queuing received objects and wakes up the waiting consumers.
+    // The objects already queued can still be popped.
+    virtual void Close();
+    bool IsClosed() const { return m_queue.IsClosed(); }
+
+    // Closed, and nothing is left for the consumers
+    virtual bool IsDrained() const { return m_queue.IsDrained(); }
+
+    // Limits the bytes and objects received and not yet taken by the consumers, 0 for no limit.
+    // nMaxDelayMilliseconds is the longest a server thread waits for room before dropping the object.
+    void SetInFlightBudget(const S_UINT64 nMaxBytes, const S_UINT64 nMaxObjects, const S_UINT32 nMaxDelayMilliseconds = 1000);
+    S_UINT32 GetMaxDelayMilliseconds() const { return m_nMaxDelayMilliseconds.load(std::memory_order_relaxed); }
+    InFlightBudget& GetInFlightBudget() { return m_budget; }
+    const InFlightBudget& GetInFlightBudget() const { return m_budget; }
+
+    S_UINT32 GetCapacity() const { return m_queue.GetCapacity(); }
+    S_UINT32 GetSize() const { return m_queue.GetSize(); }
+    S_UINT32 GetHighWaterSize() const { return m_queue.GetHighWaterSize(); }
+    S_UINT64 GetNumberReceived() const { return m_nNumReceived.load(std::memory_order_relaxed); }
+    S_UINT64 GetNumberDropped() const { return m_nNumDropped.load(std::memory_order_relaxed); }
+    S_UINT64 GetNumberOfErrors() const { return m_nNumErrors.load(std::memory_order_relaxed); }
+
+    // Object deleted instead of reaching the consumers
+    struct Drop
+    {
+        std::string m_strModality;
+        std::string m_strClientIP;
+        std::string m_strReason;
+    };
+
+    // Most recent drops, oldest first. Only the last nMaxDrops are kept, GetNumberDropped counts them all.
+    std::vector<Drop> GetDrops() const;
+    static const S_UINT32 nMaxDrops = 64;
+
+protected:
+    virtual void OnReceiveDicosFileError(const ErrorLog &errorlog, const Utils::SessionData &sessiondata);
+
+    virtual void OnReceiveDicosFile(Utils::DicosData<CT> &ct, const ErrorLog &errorlog);
+    virtual void OnReceiveDicosFile(Utils::DicosData<DX> &dx, const ErrorLog &errorlog);
+    virtual void OnReceiveDicosFile(Utils::DicosData<TDR> &tdr, const ErrorLog &errorlog);
+
+    // Queues the received object, or releases it if it cannot be queued. Returns true if it was queued.
+    virtual bool Push(ReceivedDicos &received);
+
+    // Takes the object out of the in-flight budget, once consumers have it or it is deleted
+    void LeavePipeline(ReceivedDicos &received);
+
+    // Counts and records the drop, then deletes the object
+    void OnDropped(ReceivedDicos &received, const char *pReason);
+
+    template<typename T>
+    void TakeOwnership(Utils::DicosData<T> &data, T *&pData, ReceivedDicos &received);
+
+    ReceivedQueue           m_queue;
+    InFlightBudget          m_budget;
+    std::atomic<S_UINT32>   m_nMaxDelayMilliseconds;
+    std::atomic<S_UINT64>   m_nNumReceived;
+    std::atomic<S_UINT64>   m_nNumDropped;
+    std::atomic<S_UINT64>   m_nNumErrors;
+
+    mutable std::mutex      m_mutexDrops;
+    std::deque<Drop>        m_dqDrops;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "ReceivedQueue.hh"
+
+#include <chrono>
+
+void ReceivedDicos::Release()
+{
+    DELETE_POINTER(m_pCT);
+    DELETE_POINTER(m_pDX);
+    DELETE_POINTER(m_pTDR);
+    m_nModality = enumUnknown;
+}
+
+ReceivedQueue::ReceivedQueue(const S_UINT32 nCapacity)
+    : m_queue(nCapacity), m_bClosed(false), m_nHighWaterSize(0), m_nNumWaitingToPop(0), m_nNumWaitingToPush(0)
+{
+}
+
+ReceivedQueue::~ReceivedQueue()
+{
+    ReceivedDicos received;
+    while (m_queue.TryPop(received))
+        received.Release();
+}
+
+void ReceivedQueue::Notify(std::atomic<S_UINT32> &nNumWaiting, std::condition_variable &cvWait)
+{
+    //Either this thread sees the waiting thread, or the waiting thread sees the change.
+    //Taking the mutex keeps the notification from landing between its check and its sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (nNumWaiting.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(m_mutexWait);
+        cvWait.notify_one();
+    }
+}
+
+bool ReceivedQueue::PushToQueue(ReceivedDicos &received)
+{
+    if (IsClosed() || !m_queue.TryPush(received))
+        return false;
+
+    const S_UINT32 nSize(GetSize());
+    S_UINT32 nHighWater(m_nHighWaterSize.load(std::memory_order_relaxed));
+    while (nHighWater < nSize &&
+           !m_nHighWaterSize.compare_exchange_weak(nHighWater, nSize, std::memory_order_relaxed)) {}
+    return true;
+}
+
+bool ReceivedQueue::TryPush(ReceivedDicos &received)
+{
+    if (!PushToQueue(received))
+        return false;
+
+    Notify(m_nNumWaitingToPop, m_cvNotEmpty);
+    return true;
+}
+
+bool ReceivedQueue::Push(ReceivedDicos &received, const S_UINT32 nTimeoutMilliseconds)
+{
+    if (TryPush(received))
+        return true;
+
+    std::unique_lock<std::mutex> lock(m_mutexWait);
+    m_nNumWaitingToPush.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst); //Pairs with the fence of Notify
+
+    bool bPushed(false);
+    m_cvNotFull.wait_for(lock, std::chrono::milliseconds(nTimeoutMilliseconds), [&]() {
+        bPushed = PushToQueue(received);
+        return bPushed || IsClosed();
+    });
+    m_nNumWaitingToPush.fetch_sub(1, std::memory_order_relaxed);
+
+    //The mutex is already held, so consumers are notified directly
+    if (bPushed)
+        m_cvNotEmpty.notify_one();
+    return bPushed;
+}
+
+bool ReceivedQueue::TryPop(ReceivedDicos &received)
+{
+    if (!m_queue.TryPop(received))
+        return false;
+
+    Notify(m_nNumWaitingToPush, m_cvNotFull);
+    return true;
+}
+
+bool ReceivedQueue::Pop(ReceivedDicos &received, const S_UINT32 nTimeoutMilliseconds)
+{
+    if (TryPop(received))
+        return true;
+
+    std::unique_lock<std::mutex> lock(m_mutexWait);
+    m_nNumWaitingToPop.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst); //Pairs with the fence of Notify
+
+    bool bPopped(false);
+    m_cvNotEmpty.wait_for(lock, std::chrono::milliseconds(nTimeoutMilliseconds), [&]() {
+        bPopped = m_queue.TryPop(received);
+        return bPopped || IsClosed();
+    });
+    m_nNumWaitingToPop.fetch_sub(1, std::memory_order_relaxed);
+
+    //The mutex is already held, so producers are notified directly
+    if (bPopped)
+        m_cvNotFull.notify_one();
+    return bPopped;
+}
+
+void ReceivedQueue::Close()
+{
+    m_bClosed.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(m_mutexWait);
+    m_cvNotEmpty.notify_all();
+    m_cvNotFull.notify_all();
+}
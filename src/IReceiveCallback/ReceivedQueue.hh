@@ -0,0 +1,86 @@
+#ifndef RECEIVEDQUEUE_FILE_H
+#define RECEIVEDQUEUE_FILE_H
+
+#include "SDICOS/DICOS.h" 
+#include "BoundedQueue.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+using namespace SDICOS;
+
+// CT, DX or TDR received by a server, owned by whoever holds it
+struct ReceivedDicos
+{
+    enum MODALITY { enumUnknown, enumCT, enumDX, enumTDR };
+
+    ReceivedDicos() : m_nModality(enumUnknown), m_pCT(S_NULL), m_pDX(S_NULL), m_pTDR(S_NULL), m_nServerPort(0), m_nSizeInBytes(0) {}
+
+    // Deletes the object, if any
+    void Release();
+
+    MODALITY    m_nModality;
+    CT*         m_pCT;
+    DX*         m_pDX;
+    TDR*        m_pTDR;
+    std::string m_strClientIP; //Client IP address that sent the data
+    std::string m_strServerIP; //Server IP address that received the data
+    S_UINT32    m_nServerPort;
+    std::string m_strFilename; //File the object was written to, if any
+    S_UINT64    m_nSizeInBytes; //Counted against the in-flight budget of the callback
+};
+
+// Bounded lock-free queue of received objects. TryPush and TryPop never block, Push and Pop
+// put the calling thread to sleep until there is room or an object, a timeout, or Close().
+// Objects still queued when the queue is destroyed are released.
+class ReceivedQueue
+{
+public:
+    explicit ReceivedQueue(const S_UINT32 nCapacity);
+    ~ReceivedQueue();
+
+    ReceivedQueue(const ReceivedQueue&) = delete;
+    ReceivedQueue& operator=(const ReceivedQueue&) = delete;
+
+    // Returns false, leaving received untouched, if the queue is full or closed
+    bool TryPush(ReceivedDicos &received);
+    bool Push(ReceivedDicos &received, const S_UINT32 nTimeoutMilliseconds);
+
+    // Returns false if the queue is empty. Objects queued before Close() can still be popped.
+    bool TryPop(ReceivedDicos &received);
+    bool Pop(ReceivedDicos &received, const S_UINT32 nTimeoutMilliseconds);
+
+    // Refuses new objects and wakes up all waiting threads
+    void Close();
+    bool IsClosed() const { return m_bClosed.load(std::memory_order_acquire); }
+
+    // Closed with nothing left to pop
+    bool IsDrained() const { return IsClosed() && 0 == GetSize(); }
+
+    S_UINT32 GetCapacity() const { return S_UINT32(m_queue.GetCapacity()); }
+    S_UINT32 GetSize() const { return S_UINT32(m_queue.GetSize()); }
+    S_UINT32 GetHighWaterSize() const { return m_nHighWaterSize.load(std::memory_order_relaxed); }
+    void ResetHighWaterSize() { m_nHighWaterSize.store(GetSize(), std::memory_order_relaxed); }
+
+protected:
+    // Pushes without notifying the waiting consumers
+    bool PushToQueue(ReceivedDicos &received);
+
+    // Wakes up a thread waiting in Pop, or in Push, if there is one
+    void Notify(std::atomic<S_UINT32> &nNumWaiting, std::condition_variable &cvWait);
+
+    BoundedQueue<ReceivedDicos> m_queue;
+    std::atomic<bool>           m_bClosed;
+    std::atomic<S_UINT32>       m_nHighWaterSize;
+
+    // Only used to put threads to sleep, the other side takes it when someone is waiting
+    std::mutex                  m_mutexWait;
+    std::condition_variable     m_cvNotEmpty;
+    std::condition_variable     m_cvNotFull;
+    std::atomic<S_UINT32>       m_nNumWaitingToPop;
+    std::atomic<S_UINT32>       m_nNumWaitingToPush;
+};
+
+#endif
\ No newline at end of file
@@ -1,15 +1,17 @@
 #include "../headers.hh"
 #include "SDICOS/IReceiveCallback.h"
+#include "../GilAwareOverride/GilAwareOverride.hh"
 #include "DataProcessing.hh"
 
 using namespace SDICOS;
 using namespace Network;
 
 
-class PyIReceiveCallback : public IReceiveCallback {
+// Server threads call in without the GIL, which is only acquired for methods overridden in Python
+class PyIReceiveCallback : public GilAwareOverride<IReceiveCallback> {
 public:
-   using IReceiveCallback::IReceiveCallback;
-    void  OnServerReady() override { PYBIND11_OVERRIDE(void,  IReceiveCallback,  OnServerReady); }
+   using GilAwareOverride<IReceiveCallback>::GilAwareOverride;
+    void  OnServerReady() override { PYDICOS_OVERRIDE(void,  IReceiveCallback,  OnServerReady); }
     void  OnReceiveDicosFileError(const ErrorLog & errolog, const Utils::SessionData & sessiondata) 
                                  override { PYBIND11_OVERRIDE_PURE(void, IReceiveCallback,  OnReceiveDicosFileError, errolog, sessiondata); }
     
@@ -0,0 +1,31 @@
+#include "../headers.hh"
+#include "InFlightBudget.hh"
+
+using namespace SDICOS;
+
+
+void export_INFLIGHTBUDGET(py::module &m)
+{
+    py::class_<InFlightBudget>(m, "InFlightBudget")
+        .def(py::init<const S_UINT64, const S_UINT64>(), py::arg("nMaxBytes") = 0, py::arg("nMaxObjects") = 0)
+        .def("SetLimits", &InFlightBudget::SetLimits, py::arg("nMaxBytes"), py::arg("nMaxObjects"))
+        .def("GetMaxBytes", &InFlightBudget::GetMaxBytes)
+        .def("GetMaxObjects", &InFlightBudget::GetMaxObjects)
+        .def("IsLimited", &InFlightBudget::IsLimited)
+        .def("TryAcquire", &InFlightBudget::TryAcquire, py::arg("nSizeInBytes"))
+        .def("Acquire", &InFlightBudget::Acquire, py::arg("nSizeInBytes"), py::arg("nTimeoutMilliseconds"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("Release", &InFlightBudget::Release, py::arg("nSizeInBytes"))
+        .def("HasRoom", &InFlightBudget::HasRoom)
+        .def("WaitForRoom", &InFlightBudget::WaitForRoom, py::arg("nTimeoutMilliseconds"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("OnRejected", &InFlightBudget::OnRejected)
+        .def("GetBytesInFlight", &InFlightBudget::GetBytesInFlight)
+        .def("GetObjectsInFlight", &InFlightBudget::GetObjectsInFlight)
+        .def("GetHighWaterBytes", &InFlightBudget::GetHighWaterBytes)
+        .def("GetNumberDelayed", &InFlightBudget::GetNumberDelayed)
+        .def("GetNumberRejected", &InFlightBudget::GetNumberRejected)
+        .def_static("EstimateSizeInBytes", py::overload_cast<CT&>(&InFlightBudget::EstimateSizeInBytes), py::arg("ct"))
+        .def_static("EstimateSizeInBytes", py::overload_cast<DX&>(&InFlightBudget::EstimateSizeInBytes), py::arg("dx"))
+        .def_static("EstimateSizeInBytes", py::overload_cast<TDR&>(&InFlightBudget::EstimateSizeInBytes), py::arg("tdr"));
+}
@@ -0,0 +1,211 @@
+#include "../headers.hh"
+#include "SDICOS/IReceiveCallback.h"
+#include "QueuedReceiveCallback.hh"
+#include "IngestReceiveCallback.hh"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace SDICOS;
+using namespace Network;
+
+
+// Hands the object over to Python, which owns it from now on
+py::dict received_to_python(ReceivedDicos &received) {
+
+    py::dict dict;
+    switch (received.m_nModality) {
+        case ReceivedDicos::enumCT:
+            dict["modality"] = "CT";
+            dict["data"] = py::cast(received.m_pCT, py::return_value_policy::take_ownership);
+            received.m_pCT = S_NULL;
+            break;
+        case ReceivedDicos::enumDX:
+            dict["modality"] = "DX";
+            dict["data"] = py::cast(received.m_pDX, py::return_value_policy::take_ownership);
+            received.m_pDX = S_NULL;
+            break;
+        case ReceivedDicos::enumTDR:
+            dict["modality"] = "TDR";
+            dict["data"] = py::cast(received.m_pTDR, py::return_value_policy::take_ownership);
+            received.m_pTDR = S_NULL;
+            break;
+        default:
+            dict["modality"] = "";
+            dict["data"] = py::none();
+            break;
+    }
+    dict["client_ip"] = received.m_strClientIP;
+    dict["server_ip"] = received.m_strServerIP;
+    dict["server_port"] = received.m_nServerPort;
+    dict["filename"] = received.m_strFilename;
+    return dict;
+}
+
+// Waits for the next object with the GIL released, in short steps so that Ctrl+C is handled.
+// Returns None on timeout, or once the callback is closed and drained.
+py::object get_received(QueuedReceiveCallback &self, py::object timeout) {
+
+    const bool bWaitForever(timeout.is_none());
+    const std::chrono::steady_clock::time_point end(std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(bWaitForever ? 0 : S_UINT64(std::max(0.0, timeout.cast<double>()) * 1000)));
+
+    ReceivedDicos received;
+    for (;;) {
+        S_UINT32 nWaitMilliseconds(100);
+        if (!bWaitForever) {
+            const S_INT64 nRemaining(std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now()).count());
+            nWaitMilliseconds = S_UINT32(std::max<S_INT64>(0, std::min<S_INT64>(nRemaining, nWaitMilliseconds)));
+        }
+
+        bool bPopped;
+        {
+            py::gil_scoped_release release;
+            bPopped = self.Pop(received, nWaitMilliseconds);
+        }
+        if (bPopped)
+            return received_to_python(received);
+
+        if (self.IsDrained() || (!bWaitForever && std::chrono::steady_clock::now() >= end))
+            return py::none();
+        if (0 != PyErr_CheckSignals())
+            throw py::error_already_set();
+    }
+}
+
+// Queues a copy of the object, Python keeps its own
+template<typename T>
+bool put_copy(QueuedReceiveCallback &self, const T &data, T *ReceivedDicos::*pData, const ReceivedDicos::MODALITY nModality) {
+
+    ReceivedDicos received;
+    received.m_nModality = nModality;
+    received.*pData = new T(data);
+    received.m_nSizeInBytes = InFlightBudget::EstimateSizeInBytes(*(received.*pData));
+
+    py::gil_scoped_release release;
+    return self.Put(received);
+}
+
+py::dict queued_stats(const QueuedReceiveCallback &self) {
+
+    py::dict dict;
+    dict["received"] = self.GetNumberReceived();
+    dict["dropped"] = self.GetNumberDropped();
+    dict["errors"] = self.GetNumberOfErrors();
+    dict["queued"] = self.GetSize();
+    dict["queued_high_water"] = self.GetHighWaterSize();
+    dict["capacity"] = self.GetCapacity();
+
+    const InFlightBudget &budget = self.GetInFlightBudget();
+    dict["in_flight_bytes"] = budget.GetBytesInFlight();
+    dict["in_flight_objects"] = budget.GetObjectsInFlight();
+    dict["in_flight_high_water_bytes"] = budget.GetHighWaterBytes();
+    dict["max_in_flight_bytes"] = budget.GetMaxBytes();
+    dict["max_in_flight_objects"] = budget.GetMaxObjects();
+    dict["delayed"] = budget.GetNumberDelayed();
+    dict["rejected"] = budget.GetNumberRejected();
+    return dict;
+}
+
+void export_QUEUEDRECEIVECALLBACK(py::module &m)
+{
+    py::class_<QueuedReceiveCallback, Network::IReceiveCallback>(m, "QueuedReceiveCallback",
+        "Receive callback queuing the received CT, DX and TDR for Python consumers. The server thread never waits "
+        "on a consumer: an object received while the queue is full or closed, or that does not fit in the in-flight "
+        "budget in time, is deleted. Each drop is counted in get_stats()[\"dropped\"] and recorded in get_drops()")
+        .def(py::init<const S_UINT32>(), py::arg("nCapacity") = 64)
+        .def("get", &get_received, py::arg("timeout") = py::none(),
+             "Next received object as a dict, waiting up to timeout seconds (forever if None). "
+             "Returns None on timeout or when the callback is closed and empty")
+        .def("get_nowait", [](QueuedReceiveCallback &self) -> py::object {
+                ReceivedDicos received;
+                if (!self.TryPop(received))
+                    return py::none();
+                return received_to_python(received);
+             }, "Next received object as a dict, or None if none is queued")
+        .def("put", [](QueuedReceiveCallback &self, const CT &ct) { return put_copy(self, ct, &ReceivedDicos::m_pCT, ReceivedDicos::enumCT); },
+             py::arg("data"))
+        .def("put", [](QueuedReceiveCallback &self, const DX &dx) { return put_copy(self, dx, &ReceivedDicos::m_pDX, ReceivedDicos::enumDX); },
+             py::arg("data"))
+        .def("put", [](QueuedReceiveCallback &self, const TDR &tdr) { return put_copy(self, tdr, &ReceivedDicos::m_pTDR, ReceivedDicos::enumTDR); },
+             py::arg("data"),
+             "Queue a copy of a CT, DX or TDR as if the server had received it, under the same budget. "
+             "Returns False if the copy was dropped")
+        .def("__iter__", [](py::object self) { return self; })
+        .def("__next__", [](QueuedReceiveCallback &self) {
+                py::object received = get_received(self, py::none());
+                if (received.is_none())
+                    throw py::stop_iteration();
+                return received;
+             })
+        .def("Close", &QueuedReceiveCallback::Close, "Stop queuing received objects and wake up the consumers")
+        .def("IsClosed", &QueuedReceiveCallback::IsClosed)
+        .def("IsDrained", &QueuedReceiveCallback::IsDrained)
+        .def("GetCapacity", &QueuedReceiveCallback::GetCapacity)
+        .def("GetSize", &QueuedReceiveCallback::GetSize)
+        .def("SetInFlightBudget", &QueuedReceiveCallback::SetInFlightBudget,
+             py::arg("nMaxBytes"), py::arg("nMaxObjects") = 0, py::arg("nMaxDelayMilliseconds") = 1000,
+             "Limit the bytes and objects received and not yet taken by the consumers, 0 for no limit. "
+             "A server thread waits up to nMaxDelayMilliseconds for room, then drops the object")
+        .def("GetMaxDelayMilliseconds", &QueuedReceiveCallback::GetMaxDelayMilliseconds)
+        .def("GetBytesInFlight", [](const QueuedReceiveCallback &self) { return self.GetInFlightBudget().GetBytesInFlight(); })
+        .def("GetObjectsInFlight", [](const QueuedReceiveCallback &self) { return self.GetInFlightBudget().GetObjectsInFlight(); })
+        .def("get_stats", &queued_stats, "Snapshot of the counters of the callback")
+        .def("get_drops", [](const QueuedReceiveCallback &self) {
+                py::list drops;
+                const std::vector<QueuedReceiveCallback::Drop> vDrops(self.GetDrops());
+                for (std::vector<QueuedReceiveCallback::Drop>::const_iterator it = vDrops.begin(); it != vDrops.end(); ++it) {
+                    py::dict dict;
+                    dict["modality"] = it->m_strModality;
+                    dict["client_ip"] = it->m_strClientIP;
+                    dict["reason"] = it->m_strReason;
+                    drops.append(dict);
+                }
+                return drops;
+             }, "Most recent dropped objects, oldest first, with the client that sent them and the reason");
+
+    py::class_<IngestReceiveCallback, QueuedReceiveCallback>(m, "IngestReceiveCallback")
+        .def(py::init([](const S_UINT32 nNumWorkers, const std::string &strOutputFolder, py::object bHandToPython,
+                         const S_UINT32 nCapacity, const S_UINT32 nOutputCapacity, const DicosFile::TRANSFER_SYNTAX nTransferSyntax) {
+                //Written objects are only handed over if asked, so that nothing waits on a consumer that does not exist
+                const bool bHand(bHandToPython.is_none() ? strOutputFolder.empty() : bHandToPython.cast<bool>());
+                return new IngestReceiveCallback(nNumWorkers, strOutputFolder, bHand, nCapacity, nOutputCapacity, nTransferSyntax);
+             }),
+             py::arg("nNumWorkers") = 4,
+             py::arg("strOutputFolder") = "",
+             py::arg("bHandToPython") = py::none(),
+             py::arg("nCapacity") = 64,
+             py::arg("nOutputCapacity") = 64,
+             py::arg("nTransferSyntax") = DicosFile::TRANSFER_SYNTAX::enumLosslessJPEG,
+             "Workers write the received objects to strOutputFolder, if set, as <modality>_<SOP Instance UID>.dcs, "
+             "never overwriting a file. bHandToPython defaults to True without an output folder and False with one: "
+             "objects handed over must be consumed, or the workers stop and later objects are dropped unwritten")
+        .def("GetNumberOfWorkers", &IngestReceiveCallback::GetNumberOfWorkers)
+        .def("GetOutputFolder", &IngestReceiveCallback::GetOutputFolder)
+        .def("IsHandingToPython", &IngestReceiveCallback::IsHandingToPython)
+        .def("GetOutputCapacity", &IngestReceiveCallback::GetOutputCapacity)
+        .def("GetOutputSize", &IngestReceiveCallback::GetOutputSize)
+        .def("get_stats", [](const IngestReceiveCallback &self) {
+                py::dict dict = queued_stats(self);
+                dict["in_progress"] = self.GetNumberInProgress();
+                dict["written"] = self.GetNumberWritten();
+                dict["write_errors"] = self.GetNumberOfWriteErrors();
+                dict["output_queued"] = self.GetOutputSize();
+                dict["output_high_water"] = self.GetOutputHighWaterSize();
+                dict["output_capacity"] = self.GetOutputCapacity();
+                dict["workers"] = self.GetNumberOfWorkers();
+                return dict;
+             }, "Snapshot of the counters of the callback and the depth of each stage")
+        .def("get_write_errors", [](const IngestReceiveCallback &self) {
+                py::list errors;
+                const std::vector<IngestReceiveCallback::WriteError> vErrors(self.GetWriteErrors());
+                for (std::vector<IngestReceiveCallback::WriteError>::const_iterator it = vErrors.begin(); it != vErrors.end(); ++it) {
+                    py::dict dict;
+                    dict["filename"] = it->m_strFilename;
+                    dict["modality"] = it->m_strModality;
+                    dict["errorlog"] = it->m_errorlog;
+                    errors.append(dict);
+                }
+                return errors;
+             }, "Most recent failed writes, oldest first, each with the ErrorLog of the write");
+}
@@ -4,9 +4,128 @@
 
 #include "../headers.hh"
 #include "SDICOS/Image2D.h"
+#include "../ImageDataType/ImageDataType.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 using namespace SDICOS;
 
+// Copies a strided (height, width) source into a row-major destination buffer.
+// Rows are copied with memcpy when the source rows are contiguous. Otherwise (transposed or Fortran-ordered inputs)
+// the copy is done in square tiles so that both the reads and the writes of a tile stay in cache.
+template<typename T>
+void copy_image_data(T* pDest, const char* pSource, const size_t nWidth, const size_t nHeight, 
+                     const py::ssize_t nRowStride, const py::ssize_t nColStride)
+{
+    constexpr size_t BLOCK_SIZE = 64;
+
+    if (nColStride == sizeof(T)) {
+        for (size_t y = 0; y < nHeight; y++) {
+            std::memcpy(pDest + y * nWidth, pSource + py::ssize_t(y) * nRowStride, nWidth * sizeof(T));
+        }
+        return;
+    }
+
+    for (size_t by = 0; by < nHeight; by += BLOCK_SIZE) {
+        const size_t nEndY = std::min(by + BLOCK_SIZE, nHeight);
+        for (size_t bx = 0; bx < nWidth; bx += BLOCK_SIZE) {
+            const size_t nEndX = std::min(bx + BLOCK_SIZE, nWidth);
+            for (size_t y = by; y < nEndY; y++) {
+                const char* pRow = pSource + py::ssize_t(y) * nRowStride;
+                T* pDestRow = pDest + y * nWidth;
+                for (size_t x = bx; x < nEndX; x++) {
+                    std::memcpy(pDestRow + x, pRow + py::ssize_t(x) * nColStride, sizeof(T));
+                }
+            }
+        }
+    }
+}
+
+// Allocates the image with the data type and size of a (height, width) NumPy array and copies the array into it.
+// Any memory layout is accepted; the copy runs with the GIL released.
+void set_data(Image2D& image, py::array array_2d_np) {
+
+    if (array_2d_np.ndim() != 2) {
+        throw std::invalid_argument("Input array must have two dimensions.");
+    }
+
+    const S_UINT32 height = static_cast<S_UINT32>(array_2d_np.shape(0));
+    const S_UINT32 width = static_cast<S_UINT32>(array_2d_np.shape(1));
+
+    DispatchNumpyDataType(array_2d_np, [&](auto tag) {
+        using T = typename decltype(tag)::type;
+
+        image.Allocate(ImageDataTraits<T>::value, width, height);
+
+        T* pDest = ImageDataTraits<T>::Get(image)->GetBuffer();
+        const char* pSource = static_cast<const char*>(array_2d_np.data());
+        const py::ssize_t nRowStride = array_2d_np.strides(0);
+        const py::ssize_t nColStride = array_2d_np.strides(1);
+
+        py::gil_scoped_release release;
+        copy_image_data<T>(pDest, pSource, width, height, nRowStride, nColStride);
+    });
+}
+
+// Returns the image as a (height, width) NumPy array of the image data type.
+// Unless bCopy is set, the array is a view on the image memory that keeps the image object alive.
+py::array get_data(py::object self, const bool bCopy) {
+
+    Image2D &image = self.cast<Image2D&>();
+    return DispatchImageDataType(image.GetImageDataType(), [&](auto tag) -> py::array {
+        using T = typename decltype(tag)::type;
+
+        T* pData = ImageDataTraits<T>::Get(image)->GetBuffer();
+        const std::vector<py::ssize_t> shape = { image.GetHeight(), image.GetWidth() };
+        if (bCopy) {
+            return py::array_t<T>(shape, pData);
+        }
+        return py::array_t<T>(shape, pData, self);
+    });
+}
+
+// Computes fSlope * value + fIntercept for every pixel, as Image2D::ApplyRescale does, and writes the result
+// into a float32 (height, width) array. The output array is allocated when none is given.
+// The image is left unchanged and the kernel runs with the GIL released.
+py::array_t<float> get_rescaled_data(Image2D &image, const float fSlope, const float fIntercept, py::object out) {
+
+    const size_t nWidth = image.GetWidth();
+    const size_t nHeight = image.GetHeight();
+
+    py::array_t<float> result;
+    if (out.is_none()) {
+        result = py::array_t<float>({ py::ssize_t(nHeight), py::ssize_t(nWidth) });
+    } 
+    else {
+        if (!py::isinstance<py::array_t<float>>(out)) {
+            throw std::invalid_argument("Output array must have float32 data type.");
+        }
+        result = out.cast<py::array_t<float>>();
+        if (result.ndim() != 2 || size_t(result.shape(0)) != nHeight || size_t(result.shape(1)) != nWidth) {
+            throw std::invalid_argument("Output array must have the (height, width) shape of the image.");
+        }
+        if (!(result.flags() & py::array::c_style) || !result.writeable()) {
+            throw std::invalid_argument("Output array must be C-contiguous and writeable.");
+        }
+    }
+
+    float* pOut = result.mutable_data();
+    DispatchImageDataType(image.GetImageDataType(), [&](auto tag) {
+        using T = typename decltype(tag)::type;
+
+        const T* pIn = ImageDataTraits<T>::Get(image)->GetBuffer();
+        const size_t nSize = nWidth * nHeight;
+
+        py::gil_scoped_release release;
+        for (size_t n = 0; n < nSize; n++) {
+            pOut[n] = static_cast<float>(pIn[n]) * fSlope + fIntercept;
+        }
+    });
+    return result;
+}
+
 void export_Image2D(py::module &m)
 {
     py::class_<Image2D, ImageDataBase>(m, "Image2D", py::buffer_protocol(), py::dynamic_attr())
@@ -83,7 +202,13 @@ void export_Image2D(py::module &m)
         .def("GetUnsigned16", (const Array2D<S_UINT16>* (Image2D::*)() const) &Image2D::GetUnsigned16, py::return_value_policy::reference_internal)     
         .def("GetUnsigned32", (const Array2D<S_UINT32>* (Image2D::*)() const) &Image2D::GetUnsigned32, py::return_value_policy::reference_internal)
         .def("GetUnsigned64", (const Array2D<S_UINT64>* (Image2D::*)() const) &Image2D::GetUnsigned64, py::return_value_policy::reference_internal)
-        .def("GetAsBuffer", &Image2D::GetAsBuffer, py::arg("mbImage"));
+        .def("GetAsBuffer", &Image2D::GetAsBuffer, py::arg("mbImage"))
+        .def_static("set_data", &set_data, "Set image data from a 2D NumPy array of any supported data type", 
+                    py::arg("image"), py::arg("data"))
+        .def("get_data", &get_data, "Get image data as a 2D NumPy array of the image data type", 
+                         py::arg("copy") = false)
+        .def("get_rescaled_data", &get_rescaled_data, "Get fSlope * image + fIntercept as a float32 2D NumPy array", 
+                                  py::arg("fSlope"), py::arg("fIntercept"), py::arg("out") = py::none());
 }
 
 #endif
\ No newline at end of file
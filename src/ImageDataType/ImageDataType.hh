@@ -0,0 +1,125 @@
+#ifndef IMAGEDATATYPE_FILE_H
+#define IMAGEDATATYPE_FILE_H
+
+#include "../headers.hh"
+#include "SDICOS/Volume.h"
+#include "SDICOS/Image2D.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace SDICOS;
+
+// Tag used to carry a pixel type through the generic lambdas passed to the dispatch functions below
+template<typename T>
+struct ImageDataTypeTag { using type = T; };
+
+// Maps a pixel type to its IMAGE_DATA_TYPE value and to the matching typed accessors of Volume and Image2D
+template<typename T> struct ImageDataTraits;
+
+#define PYDICOS_IMAGE_DATA_TRAITS(TYPE, DATA_TYPE, GETTER)                                    \
+    template<> struct ImageDataTraits<TYPE> {                                                 \
+        static constexpr ImageDataBase::IMAGE_DATA_TYPE value = ImageDataBase::DATA_TYPE;     \
+        static Array3DLarge<TYPE>* Get(Volume &volume) { return volume.GETTER(); }            \
+        static Array2D<TYPE>* Get(Image2D &image) { return image.GETTER(); }                  \
+    };
+
+PYDICOS_IMAGE_DATA_TRAITS(S_INT8, enumSigned8Bit, GetSigned8)
+PYDICOS_IMAGE_DATA_TRAITS(S_UINT8, enumUnsigned8Bit, GetUnsigned8)
+PYDICOS_IMAGE_DATA_TRAITS(S_INT16, enumSigned16Bit, GetSigned16)
+PYDICOS_IMAGE_DATA_TRAITS(S_UINT16, enumUnsigned16Bit, GetUnsigned16)
+PYDICOS_IMAGE_DATA_TRAITS(S_INT32, enumSigned32Bit, GetSigned32)
+PYDICOS_IMAGE_DATA_TRAITS(S_UINT32, enumUnsigned32Bit, GetUnsigned32)
+PYDICOS_IMAGE_DATA_TRAITS(S_INT64, enumSigned64Bit, GetSigned64)
+PYDICOS_IMAGE_DATA_TRAITS(S_UINT64, enumUnsigned64Bit, GetUnsigned64)
+PYDICOS_IMAGE_DATA_TRAITS(float, enumFloat, GetFloat)
+
+#undef PYDICOS_IMAGE_DATA_TRAITS
+
+// Calls f(ImageDataTypeTag<T>()) with the pixel type T matching nDataType
+template<typename F>
+decltype(auto) DispatchImageDataType(const ImageDataBase::IMAGE_DATA_TYPE nDataType, F &&f)
+{
+    switch (nDataType) {
+        case ImageDataBase::enumSigned8Bit:     return f(ImageDataTypeTag<S_INT8>());
+        case ImageDataBase::enumUnsigned8Bit:   return f(ImageDataTypeTag<S_UINT8>());
+        case ImageDataBase::enumSigned16Bit:    return f(ImageDataTypeTag<S_INT16>());
+        case ImageDataBase::enumUnsigned16Bit:  return f(ImageDataTypeTag<S_UINT16>());
+        case ImageDataBase::enumSigned32Bit:    return f(ImageDataTypeTag<S_INT32>());
+        case ImageDataBase::enumUnsigned32Bit:  return f(ImageDataTypeTag<S_UINT32>());
+        case ImageDataBase::enumSigned64Bit:    return f(ImageDataTypeTag<S_INT64>());
+        case ImageDataBase::enumUnsigned64Bit:  return f(ImageDataTypeTag<S_UINT64>());
+        case ImageDataBase::enumFloat:          return f(ImageDataTypeTag<float>());
+        default:
+            throw std::invalid_argument("Undefined image data type.");
+    }
+}
+
+// Calls f(ImageDataTypeTag<T>()) with the pixel type T matching the dtype of the NumPy array
+template<typename F>
+decltype(auto) DispatchNumpyDataType(const py::array &array, F &&f)
+{
+    if (py::isinstance<py::array_t<S_INT8>>(array))    return f(ImageDataTypeTag<S_INT8>());
+    if (py::isinstance<py::array_t<S_UINT8>>(array))   return f(ImageDataTypeTag<S_UINT8>());
+    if (py::isinstance<py::array_t<S_INT16>>(array))   return f(ImageDataTypeTag<S_INT16>());
+    if (py::isinstance<py::array_t<S_UINT16>>(array))  return f(ImageDataTypeTag<S_UINT16>());
+    if (py::isinstance<py::array_t<S_INT32>>(array))   return f(ImageDataTypeTag<S_INT32>());
+    if (py::isinstance<py::array_t<S_UINT32>>(array))  return f(ImageDataTypeTag<S_UINT32>());
+    if (py::isinstance<py::array_t<S_INT64>>(array))   return f(ImageDataTypeTag<S_INT64>());
+    if (py::isinstance<py::array_t<S_UINT64>>(array))  return f(ImageDataTypeTag<S_UINT64>());
+    if (py::isinstance<py::array_t<float>>(array))     return f(ImageDataTypeTag<float>());
+    throw std::invalid_argument("Unsupported NumPy data type: " + std::string(py::str(array.dtype())));
+}
+
+// Returns true when the slices of the array lie back to back in a single block of memory
+template<typename T>
+bool AreSlicesContiguous(Array3DLarge<T> &array)
+{
+    const size_t nSliceSize = size_t(array.GetWidth()) * array.GetHeight();
+    T* pFirst = array.GetDepth() > 0 ? array.GetSlice(0)->GetBuffer() : S_NULL;
+    for (S_UINT32 z = 1; z < array.GetDepth(); z++) {
+        if (array.GetSlice(z)->GetBuffer() != pFirst + z * nSliceSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the data of the array as a (depth, height, width) NumPy array.
+// When the slices are contiguous and bCopy is false, the NumPy array is a view on the slices that keeps owner alive.
+// Otherwise the slices are gathered into a new NumPy array with the GIL released.
+template<typename T>
+py::array Array3DLargeToNumpy(Array3DLarge<T> &array, py::handle owner, const bool bCopy)
+{
+    const S_UINT32 nWidth = array.GetWidth();
+    const S_UINT32 nHeight = array.GetHeight();
+    const S_UINT32 nDepth = array.GetDepth();
+    const std::vector<py::ssize_t> shape = { nDepth, nHeight, nWidth };
+
+    if (!bCopy && nDepth > 0 && AreSlicesContiguous(array)) {
+        return py::array_t<T>(shape, array.GetSlice(0)->GetBuffer(), owner);
+    }
+
+    py::array_t<T> result(shape);
+    T* pDest = result.mutable_data();
+    const size_t nSliceSize = size_t(nWidth) * nHeight;
+    {
+        py::gil_scoped_release release;
+        for (S_UINT32 z = 0; z < nDepth; z++) {
+            std::memcpy(pDest + z * nSliceSize, array.GetSlice(z)->GetBuffer(), nSliceSize * sizeof(T));
+        }
+    }
+    return result;
+}
+
+// Returns the data of the volume as a (depth, height, width) NumPy array of the matching data type
+inline py::array VolumeToNumpy(Volume &volume, const ImageDataBase::IMAGE_DATA_TYPE nDataType, py::handle owner, const bool bCopy)
+{
+    return DispatchImageDataType(nDataType, [&](auto tag) -> py::array {
+        using T = typename decltype(tag)::type;
+        return Array3DLargeToNumpy<T>(*ImageDataTraits<T>::Get(volume), owner, bCopy);
+    });
+}
+
+#endif
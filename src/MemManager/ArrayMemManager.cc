@@ -0,0 +1,64 @@
+#include "ArrayMemManager.hh"
+
+#include <cstdint>
+
+ArrayMemoryManager::ArrayMemoryManager(unsigned char* pData, const S_UINT64 nSizeInBytes, const S_UINT64 nSliceStrideInBytes)
+	: m_pData(pData), m_nSizeInBytes(nSizeInBytes), m_nSliceStrideInBytes(nSliceStrideInBytes),
+	  m_nOffset(0), m_nNumInUse(0)
+{
+}
+
+ArrayMemoryManager::~ArrayMemoryManager()
+{
+}
+
+bool ArrayMemoryManager::OnAllocate(MemoryBuffer &mbAllocate, const S_UINT64 nSizeInBytesToAllocate)
+{
+	const S_UINT64 nRegionSize(m_nSliceStrideInBytes > 0 ? m_nSliceStrideInBytes : nSizeInBytesToAllocate);
+
+	//Reserve the region, several reads may share the memory manager
+	S_UINT64 nOffset(m_nOffset.load(std::memory_order_relaxed));
+	do {
+		if (nSizeInBytesToAllocate > nRegionSize || nOffset + nSizeInBytesToAllocate > m_nSizeInBytes) {
+			m_stats.OnMiss(nSizeInBytesToAllocate);
+			return false;
+		}
+	} while (!m_nOffset.compare_exchange_weak(nOffset, nOffset + nRegionSize, std::memory_order_relaxed));
+
+	m_nNumInUse.fetch_add(1, std::memory_order_relaxed);
+	mbAllocate.SetBuffer(m_pData + nOffset, nSizeInBytesToAllocate);
+	m_stats.OnHit(nSizeInBytesToAllocate);
+	return true;
+}
+
+bool ArrayMemoryManager::OnDeallocate(MemoryBuffer &mbDeallocate)
+{
+	//If memory policy does not match, then the buffer was not allocated by this class
+	if (GetSliceMemoryPolicy() != mbDeallocate.GetMemoryPolicy())
+		return false;
+
+	const std::uintptr_t nData(reinterpret_cast<std::uintptr_t>(mbDeallocate.GetData()));
+	const std::uintptr_t nStart(reinterpret_cast<std::uintptr_t>(m_pData));
+	if (S_NULL == mbDeallocate.GetData() || nData < nStart || nData >= nStart + m_nSizeInBytes)
+		return false;
+
+	//The region stays reserved until the next rewind
+	m_nNumInUse.fetch_sub(1, std::memory_order_relaxed);
+	m_stats.OnDeallocate(mbDeallocate.GetSize());
+	return true;
+}
+
+MemoryBuffer::MEMORY_POLICY ArrayMemoryManager::OnGetSliceMemoryPolicy()const
+{
+	//Tell the DICOS library it does not own the data, so it never deletes the caller's buffer
+	return MemoryBuffer::enumPolicy_DoesNotOwnData;
+}
+
+bool ArrayMemoryManager::Rewind()
+{
+	if (m_nNumInUse.load(std::memory_order_acquire) > 0)
+		return false;
+
+	m_nOffset.store(0, std::memory_order_release);
+	return true;
+}
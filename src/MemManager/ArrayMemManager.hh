@@ -0,0 +1,60 @@
+#ifndef ARRAYMEMORYMANAGER_FILE_H
+#define ARRAYMEMORYMANAGER_FILE_H
+
+#include "SDICOS/DICOS.h" //Header for DICOS
+#include "MemoryManagerStats.hh"
+
+#include <atomic>
+
+using namespace SDICOS;
+
+//Memory manager handing out consecutive regions of a caller-supplied buffer, e.g. a NumPy array.
+//The slices of a volume are allocated in order, so after a read the buffer holds the decoded volume
+//and no copy is needed. Regions are not reused until Rewind() is called.
+class ArrayMemoryManager : public IMemoryManager
+{
+public:
+	//pData must stay valid while the memory manager is in use. With nSliceStrideInBytes = 0 regions
+	//are packed one after the other, otherwise region n starts n * nSliceStrideInBytes bytes into the buffer.
+	ArrayMemoryManager(unsigned char* pData, const S_UINT64 nSizeInBytes, const S_UINT64 nSliceStrideInBytes = 0);
+	virtual ~ArrayMemoryManager();
+
+	ArrayMemoryManager(const ArrayMemoryManager&) = delete;
+	ArrayMemoryManager& operator=(const ArrayMemoryManager&) = delete;
+
+	//Provides the next region of the buffer. Returns false, letting the DICOS library allocate the
+	//memory itself, if the remainder of the buffer or the slice stride is too small.
+	virtual bool OnAllocate(MemoryBuffer &mbAllocate, const S_UINT64 nSizeInBytesToAllocate);
+
+	//Returns false for buffers that are not regions of the buffer
+	virtual bool OnDeallocate(MemoryBuffer &mbDeallocate);
+
+	//The caller owns the buffer, the DICOS library only borrows it
+	virtual MemoryBuffer::MEMORY_POLICY OnGetSliceMemoryPolicy()const;
+
+	//Starts handing out regions from the beginning of the buffer again.
+	//Returns false, and does nothing, while regions are still in use.
+	bool Rewind();
+
+	S_UINT64 GetSizeInBytes() const { return m_nSizeInBytes; }
+	S_UINT64 GetSliceStrideInBytes() const { return m_nSliceStrideInBytes; }
+
+	//Number of bytes of the buffer handed out since the last rewind
+	S_UINT64 GetBytesUsed() const { return m_nOffset.load(std::memory_order_relaxed); }
+
+	//Number of regions given to the DICOS library and not given back yet
+	S_UINT32 GetNumberOfRegionsInUse() const { return m_nNumInUse.load(std::memory_order_relaxed); }
+
+	//Allocation counters of the memory manager
+	MemoryManagerStats& GetStats() { return m_stats; }
+	const MemoryManagerStats& GetStats() const { return m_stats; }
+
+protected:
+	unsigned char* const		m_pData;
+	const S_UINT64				m_nSizeInBytes;
+	const S_UINT64				m_nSliceStrideInBytes;
+	std::atomic<S_UINT64>		m_nOffset; //Start of the next region
+	std::atomic<S_UINT32>		m_nNumInUse;
+	MemoryManagerStats			m_stats;
+};
+#endif
\ No newline at end of file
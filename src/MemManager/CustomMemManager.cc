@@ -21,6 +21,7 @@ bool CustomMemoryManager::OnAllocate(SDICOS::MemoryBuffer &mbAllocate, const SDI
 	//allocate a buffer itself.
 	if (m_nBufferSizeInBytes <= nSizeInBytesToAllocate)
 	{
+		m_stats.OnMiss(nSizeInBytesToAllocate);
 		return false;
 	}
 
@@ -30,13 +31,12 @@ bool CustomMemoryManager::OnAllocate(SDICOS::MemoryBuffer &mbAllocate, const SDI
 	{
 		if (pBuffer->first)
 		{
-			std::cout << "Allocated slice " << n << std::endl; //Print out the index of the buffer
-
 			//Even though the buffer allocated may be larger, only state the requested size
 			//has been provided.
 			pBuffer->first = false; //Indicate buffer is no longer available
 			mbAllocate.SetBuffer(pBuffer->second.GetData(), nSizeInBytesToAllocate);
 			m_mapUsedBuffers[pBuffer->second.GetData()] = n;	//Track the used memory buffer
+			m_stats.OnHit(nSizeInBytesToAllocate);
 
 			//Return true to tell the DICOS library this class provided a buffer of the requested size
 			return true;
@@ -44,6 +44,7 @@ bool CustomMemoryManager::OnAllocate(SDICOS::MemoryBuffer &mbAllocate, const SDI
 	}
 
 	//No more buffers available, return false so the DICOS library handls allocation
+	m_stats.OnMiss(nSizeInBytesToAllocate);
 	return false;
 }
 
@@ -60,10 +61,9 @@ bool CustomMemoryManager::OnDeallocate(SDICOS::MemoryBuffer &mbDeallocate)
 	if (m_mapUsedBuffers.end() == it)
 		return false; //Returning false allows the DICOS library to delete the buffer based on its memory policy
 
-	std::cout << "Deallocated slice " << it->second << std::endl; //Print out the index of the buffer
-
 	m_vBuffers[it->second].first = true; //Mark the buffer as available for use in OnAllocate()
 	m_mapUsedBuffers.erase(it); //Remove buffer from the 'used' list
+	m_stats.OnDeallocate(mbDeallocate.GetSize());
 
 	//Returning true tells the DICOS library this class has deallocated the buffer
 	return true;
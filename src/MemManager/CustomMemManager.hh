@@ -2,6 +2,7 @@
 #define CUSTOMMEMORYMANAGER_FILE_H
 
 #include "SDICOS/DICOS.h" //Header for DICOS
+#include "MemoryManagerStats.hh"
 #include <iostream>
 #include <map>
 #include "../headers.hh"
@@ -17,6 +18,7 @@ public:
 	Array1D< std::pair<bool, MemoryBuffer> >			m_vBuffers;	//Array of preallocated buffers
 	std::map<const unsigned char*, S_UINT32>			m_mapUsedBuffers; //Simple tracking for which slices are used
 	const S_UINT64										m_nBufferSizeInBytes; //Size of each buffer
+	MemoryManagerStats									m_stats; //Allocation counters
 
 	 //Constructor preallocates the buffers
 	CustomMemoryManager(const S_UINT64 m_nBufferSizeInBytes = (512 * 512 * 8), const S_UINT32 nNumBuffersToAllocated = 500);
@@ -34,6 +36,10 @@ public:
 	//to return MemoryBuffer::enumPolicy_DoesNotOwnData
 	virtual MemoryBuffer::MEMORY_POLICY OnGetSliceMemoryPolicy()const;
 
+	//Allocation counters of the memory manager
+	MemoryManagerStats& GetStats() { return m_stats; }
+	const MemoryManagerStats& GetStats() const { return m_stats; }
+
 	float* getData() {
 		std::pair<bool, MemoryBuffer> *pBuffer(m_vBuffers.GetBuffer());
 		MemoryBuffer& MemBuf = pBuffer->second;
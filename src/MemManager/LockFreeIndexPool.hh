@@ -0,0 +1,77 @@
+#ifndef LOCKFREEINDEXPOOL_FILE_H
+#define LOCKFREEINDEXPOOL_FILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Lock-free stack of the free indices of a fixed size pool.
+// The head packs a 32-bit ABA tag with the index on top of the stack, so Pop and Push
+// are a single compare-and-swap each and never block.
+class LockFreeIndexPool
+{
+public:
+	static const std::uint32_t s_nEmpty = 0xFFFFFFFF;
+
+	//Indices in [0, nNumFree) start free, the others are pushed when they become available
+	explicit LockFreeIndexPool(const std::uint32_t nCount)
+		: LockFreeIndexPool(nCount, nCount) {}
+
+	LockFreeIndexPool(const std::uint32_t nCount, std::uint32_t nNumFree)
+		: m_nCount(nCount), m_pNext(new std::atomic<std::uint32_t>[nCount > 0 ? nCount : 1])
+	{
+		if (nNumFree > nCount)
+			nNumFree = nCount;
+		for (std::uint32_t n(0); n < nCount; ++n)
+			m_pNext[n].store(n + 1 < nNumFree ? n + 1 : s_nEmpty, std::memory_order_relaxed);
+		m_nFree.store(nNumFree, std::memory_order_relaxed);
+		m_nHead.store(nNumFree > 0 ? 0 : s_nEmpty, std::memory_order_release);
+	}
+
+	LockFreeIndexPool(const LockFreeIndexPool&) = delete;
+	LockFreeIndexPool& operator=(const LockFreeIndexPool&) = delete;
+
+	//Takes a free index, returns false if the pool is exhausted
+	bool Pop(std::uint32_t& nIndex)
+	{
+		std::uint64_t nHead = m_nHead.load(std::memory_order_acquire);
+		for (;;) {
+			const std::uint32_t nTop = std::uint32_t(nHead);
+			if (s_nEmpty == nTop)
+				return false;
+			const std::uint32_t nNext = m_pNext[nTop].load(std::memory_order_relaxed);
+			if (m_nHead.compare_exchange_weak(nHead, MakeHead(nHead, nNext), std::memory_order_acq_rel, std::memory_order_acquire)) {
+				m_nFree.fetch_sub(1, std::memory_order_relaxed);
+				nIndex = nTop;
+				return true;
+			}
+		}
+	}
+
+	//Gives back an index taken with Pop
+	void Push(const std::uint32_t nIndex)
+	{
+		std::uint64_t nHead = m_nHead.load(std::memory_order_relaxed);
+		do {
+			m_pNext[nIndex].store(std::uint32_t(nHead), std::memory_order_relaxed);
+		} while (!m_nHead.compare_exchange_weak(nHead, MakeHead(nHead, nIndex), std::memory_order_release, std::memory_order_relaxed));
+		m_nFree.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	std::uint32_t GetCount() const { return m_nCount; }
+
+	//Number of free indices, exact when the pool is idle
+	std::uint32_t GetNumberOfFree() const { return m_nFree.load(std::memory_order_relaxed); }
+
+private:
+	static std::uint64_t MakeHead(const std::uint64_t nHead, const std::uint32_t nIndex)
+	{
+		return (((nHead >> 32) + 1) << 32) | nIndex;
+	}
+
+	const std::uint32_t								m_nCount;
+	std::unique_ptr<std::atomic<std::uint32_t>[]>	m_pNext; //Next free index below each free index
+	std::atomic<std::uint64_t>						m_nHead; //ABA tag << 32 | index on top of the stack
+	std::atomic<std::uint32_t>						m_nFree;
+};
+#endif
\ No newline at end of file
@@ -4,16 +4,85 @@
 
 #include "SDICOS/MemoryBuffer.h"
 
+#include <cstring>
+#include <optional>
+
 namespace py = pybind11;
 using namespace SDICOS;
 
+// Sets the data of the memory buffer from any C-contiguous Python buffer.
+// By default the first nSize bytes are copied into memory owned by the memory buffer.
+// With bAdopt, the memory buffer points directly at the Python buffer (enumPolicy_DoesNotOwnData)
+// and keeps a reference on it until the data is replaced or the memory buffer is destroyed.
+// Only writable buffers can be adopted, and only by memory buffers owned by Python: the reference
+// lives on the Python object, which a memory buffer owned by a DICOS object can outlive.
+void set_buffer(py::object self, py::buffer pBuffer, std::optional<size_t> nSize, const bool bAdopt) {
+
+    MemoryBuffer &membuff = self.cast<MemoryBuffer&>();
+    py::buffer_info info = pBuffer.request();
+    if (bAdopt && info.readonly) {
+        throw std::runtime_error("Cannot adopt a read-only buffer, use bAdopt=False to copy it");
+    }
+    if (bAdopt && !reinterpret_cast<py::detail::instance*>(self.ptr())->owned) {
+        throw std::runtime_error("Only a MemoryBuffer created from Python can adopt a buffer, use bAdopt=False to copy it");
+    }
+    py::ssize_t nExpectedStride = info.itemsize;
+    for (py::ssize_t n = info.ndim - 1; n >= 0; n--) {
+        if (info.shape[n] > 1 && info.strides[n] != nExpectedStride) {
+            throw std::runtime_error("Expected a C-contiguous buffer");
+        }
+        nExpectedStride *= info.shape[n];
+    }
+
+    const size_t nBufferSize = size_t(info.size) * size_t(info.itemsize);
+    const size_t nBytes = nSize.value_or(nBufferSize);
+    if (nBytes > nBufferSize) {
+        throw std::runtime_error("nSize is larger than the buffer");
+    }
+
+    if (bAdopt) {
+        membuff.SetBuffer(static_cast<unsigned char*>(info.ptr), nBytes);
+        membuff.SetMemoryPolicy(MemoryBuffer::MEMORY_POLICY::enumPolicy_DoesNotOwnData);
+        self.attr("_buffer_keep_alive") = pBuffer;
+        return;
+    }
+
+    unsigned char* new_data = new unsigned char[nBytes];
+    std::memcpy(new_data, info.ptr, nBytes);
+    membuff.SetBuffer(new_data, nBytes);
+    membuff.SetMemoryPolicy(MemoryBuffer::MEMORY_POLICY::enumPolicy_OwnsData);
+    self.attr("_buffer_keep_alive") = py::none();
+}
+
+// Moves the data out of the memory buffer into a read-write memoryview, leaving the memory buffer empty.
+// Data owned by the memory buffer changes hands without being copied and is freed with the memoryview;
+// data the memory buffer does not own is copied.
+py::memoryview move_to_memoryview(py::object self) {
+
+    MemoryBuffer &membuff = self.cast<MemoryBuffer&>();
+    py::array_t<unsigned char> data;
+
+    if (membuff.OwnsData()) {
+        MemoryBuffer* pOwner = new MemoryBuffer();
+        MemoryBuffer::Move(*pOwner, membuff);
+        py::capsule owner(pOwner, [](void* p) { delete static_cast<MemoryBuffer*>(p); });
+        data = py::array_t<unsigned char>(py::ssize_t(pOwner->GetSize()), pOwner->GetData(), owner);
+    } 
+    else {
+        data = py::array_t<unsigned char>(py::ssize_t(membuff.GetSize()), membuff.GetData());
+        membuff.FreeMemory();
+    }
+    self.attr("_buffer_keep_alive") = py::none();
+    return py::memoryview(data);
+}
+
 void export_MEMORYBUFFER(py::module &m)
 {
     py::enum_<MemoryBuffer::MEMORY_POLICY>(m, "MEMORY_POLICY")
         .value("enumPolicy_DoesNotOwnData", MemoryBuffer::MEMORY_POLICY::enumPolicy_DoesNotOwnData)
         .value("enumPolicy_OwnsData", MemoryBuffer::MEMORY_POLICY::enumPolicy_OwnsData);
 
-    py::class_<MemoryBuffer>(m, "MemoryBuffer", py::buffer_protocol())
+    py::class_<MemoryBuffer>(m, "MemoryBuffer", py::buffer_protocol(), py::dynamic_attr())
         .def(py::init<>())
         .def(py::init<const MemoryBuffer&>(), py::arg("obj"))
         .def("__copy__", [](const MemoryBuffer &self) { return MemoryBuffer(self); })
@@ -27,17 +96,12 @@ void export_MEMORYBUFFER(py::module &m)
         .def("GrowToSafe", &MemoryBuffer::GrowToSafe, py::arg("nSize"))
         .def("GetSize", &MemoryBuffer::GetSize)
         .def("FreeMemory", &MemoryBuffer::FreeMemory)
-        .def("SetBuffer", [](MemoryBuffer &self, py::buffer pBuffer, size_t nSize) {
-            py::buffer_info info = pBuffer.request();
-            if (info.ndim != 1 || info.format != py::format_descriptor<unsigned char>::format()) {
-                throw std::runtime_error("Expected a buffer of unsigned char type and one dimension");
-            }
-            unsigned char* new_data = new unsigned char[nSize];
-            std::memcpy(new_data, info.ptr, nSize);
-            self.SetBuffer(new_data, nSize);
-            self.SetMemoryPolicy(MemoryBuffer::MEMORY_POLICY::enumPolicy_OwnsData);
-        }, py::arg("pBuffer"), py::arg("nSize"))
+        .def("SetBuffer", &set_buffer, 
+                          py::arg("pBuffer"), 
+                          py::arg("nSize") = py::none(), 
+                          py::arg("bAdopt") = false)
         .def_static("Move", &MemoryBuffer::Move, py::arg("membuffDest"), py::arg("membuffSrc"))
+        .def("move_to_memoryview", &move_to_memoryview, "Move the data out of the memory buffer into a memoryview")
         .def_buffer([](MemoryBuffer &m) -> py::buffer_info {
             auto size = m.GetSize();
             auto *data = m.GetData();
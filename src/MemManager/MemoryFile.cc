@@ -0,0 +1,66 @@
+#include "../headers.hh"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include "SDICOS/MemoryBuffer.h"
+#include "SDICOS/MemoryFile.h"
+
+namespace py = pybind11;
+using namespace SDICOS;
+
+// Points the memory file at the bytes of a C-contiguous Python buffer without copying them.
+// The memory file keeps a reference on the buffer, which is only read from.
+void set_read_buffer(py::object self, py::buffer pBuffer) {
+
+    MemoryFile &memfile = self.cast<MemoryFile&>();
+    py::buffer_info info = pBuffer.request();
+    if (!py::bool_(py::memoryview(pBuffer).attr("c_contiguous"))) {
+        throw std::runtime_error("Expected a C-contiguous buffer");
+    }
+
+    MemoryBuffer &membuff = memfile.GetBuffer();
+    membuff.FreeMemory();
+    membuff.SetBuffer(static_cast<unsigned char*>(info.ptr), size_t(info.size) * size_t(info.itemsize));
+    membuff.SetMemoryPolicy(MemoryBuffer::MEMORY_POLICY::enumPolicy_DoesNotOwnData);
+    self.attr("_buffer_keep_alive") = pBuffer;
+}
+
+// Moves the content of the memory file, e.g. the output of Write, into a memoryview without copying it.
+// The memoryview owns the storage, so a later Write or set_read_buffer cannot free it; the memory file is left empty.
+py::memoryview move_to_memoryview(py::object self) {
+
+    MemoryFile &memfile = self.cast<MemoryFile&>();
+    MemoryBuffer &membuff = memfile.GetBuffer();
+    py::array_t<unsigned char> data;
+    if (membuff.OwnsData()) {
+        MemoryBuffer* pOwner = new MemoryBuffer();
+        MemoryBuffer::Move(*pOwner, membuff);
+        py::capsule owner(pOwner, [](void* p) { delete static_cast<MemoryBuffer*>(p); });
+        data = py::array_t<unsigned char>(py::ssize_t(pOwner->GetSize()), pOwner->GetData(), owner);
+    } else {
+        // Content set by set_read_buffer belongs to the Python buffer, which the view keeps alive instead
+        py::object keep_alive = py::getattr(self, "_buffer_keep_alive", py::none());
+        data = py::array_t<unsigned char>(py::ssize_t(membuff.GetSize()), membuff.GetData(), keep_alive);
+        data.attr("setflags")(py::arg("write") = false);
+        membuff.FreeMemory();
+    }
+    self.attr("_buffer_keep_alive") = py::none();
+    return py::memoryview(data);
+}
+
+void export_MEMORYFILE(py::module &m)
+{
+    py::class_<MemoryFile>(m, "MemoryFile", py::dynamic_attr())
+        .def(py::init<>())
+        .def_static("from_buffer", [](py::buffer pBuffer) {
+            py::object memfile = py::cast(new MemoryFile(), py::return_value_policy::take_ownership);
+            set_read_buffer(memfile, pBuffer);
+            return memfile;
+        }, py::arg("pBuffer"), "Create a memory file reading from the given buffer without copying it")
+        .def("__len__", [](MemoryFile &self) { return self.GetBuffer().GetSize(); })
+        .def("set_read_buffer", &set_read_buffer, py::arg("pBuffer"),
+             "Read from the given bytes, bytearray or memoryview without copying it")
+        .def("GetBuffer", py::overload_cast<>(&MemoryFile::GetBuffer), py::return_value_policy::reference_internal)
+        .def("move_to_memoryview", &move_to_memoryview,
+             "Move the content of the memory file into a memoryview without copying it, leaving the memory file empty");
+}
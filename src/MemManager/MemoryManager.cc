@@ -1,22 +1,76 @@
 #include "../headers.hh"
+#include "../GilAwareOverride/GilAwareOverride.hh"
 
 #include "CustomMemManager.hh"
+#include "PooledMemManager.hh"
+#include "SlabPoolMemManager.hh"
+#include "ArrayMemManager.hh"
 
 
-class PyCustomMemoryManager : public CustomMemoryManager {
+class PyCustomMemoryManager : public GilAwareOverride<CustomMemoryManager> {
 public:
-    using CustomMemoryManager::CustomMemoryManager;
+    using GilAwareOverride<CustomMemoryManager>::GilAwareOverride;
     bool OnAllocate(MemoryBuffer &mbAllocate, const S_UINT64 nSizeInBytesToAllocate) override { 
-        PYBIND11_OVERRIDE(bool,  CustomMemoryManager, OnAllocate, mbAllocate, nSizeInBytesToAllocate); 
+        PYDICOS_OVERRIDE(bool,  CustomMemoryManager, OnAllocate, mbAllocate, nSizeInBytesToAllocate); 
     }
     bool OnDeallocate(MemoryBuffer &mbDeallocate) override { 
-        PYBIND11_OVERRIDE(bool,  CustomMemoryManager, OnDeallocate, mbDeallocate); 
+        PYDICOS_OVERRIDE(bool,  CustomMemoryManager, OnDeallocate, mbDeallocate); 
     }
     MemoryBuffer::MEMORY_POLICY OnGetSliceMemoryPolicy() const override {
-        PYBIND11_OVERRIDE( MemoryBuffer::MEMORY_POLICY,  CustomMemoryManager, OnGetSliceMemoryPolicy);
+        PYDICOS_OVERRIDE(MemoryBuffer::MEMORY_POLICY,  CustomMemoryManager, OnGetSliceMemoryPolicy);
     }
 };
 
+// Snapshot of the allocation counters as a dict. The histogram maps the smallest size
+// of each power-of-two bin to its number of requests, empty bins are left out.
+py::dict stats_to_dict(const MemoryManagerStats &stats) {
+
+    const MemoryManagerStats::Snapshot snapshot(stats.GetSnapshot());
+    py::dict histogram;
+    for (S_UINT32 n(0); n < MemoryManagerStats::s_nNumHistogramBins; ++n) {
+        if (snapshot.m_vHistogram[n] > 0)
+            histogram[py::int_(n > 0 ? S_UINT64(1) << (n - 1) : 0)] = snapshot.m_vHistogram[n];
+    }
+
+    py::dict dict;
+    dict["hits"] = snapshot.m_nHits;
+    dict["misses"] = snapshot.m_nMisses;
+    dict["deallocations"] = snapshot.m_nDeallocations;
+    dict["bytes_outstanding"] = snapshot.m_nBytesOutstanding;
+    dict["high_water_bytes"] = snapshot.m_nHighWaterBytes;
+    dict["histogram"] = histogram;
+    return dict;
+}
+
+// Where the slabs of a slab pool come from. The transparent huge page bytes are read from
+// /proc/self/smaps, the other values are counters kept while the slabs are allocated.
+py::dict get_slab_stats(const SlabPoolMemoryManager &memMgr) {
+
+    const SlabMemory &slabMemory(memMgr.GetSlabMemory());
+    const SlabMemory::Stats stats(slabMemory.GetStats());
+    py::dict dict;
+    dict["huge_pages"] = slabMemory.IsUsingHugePages();
+    dict["numa_local"] = slabMemory.IsNumaLocal();
+    dict["huge_page_size"] = slabMemory.GetHugePageSizeInBytes();
+    dict["slab_bytes"] = stats.m_nSlabBytes;
+    dict["hugetlb_bytes"] = stats.m_nHugeTlbBytes;
+    dict["madvised_bytes"] = stats.m_nMadvisedBytes;
+    dict["transparent_huge_page_bytes"] = slabMemory.QueryTransparentHugePageBytes();
+    dict["numa_bound_bytes"] = stats.m_nNumaBoundBytes;
+    dict["numa_node"] = stats.m_nNumaNode;
+    return dict;
+}
+
+template<typename T>
+py::dict get_stats(const T &memMgr) {
+    return stats_to_dict(memMgr.GetStats());
+}
+
+template<typename T>
+void reset_stats(T &memMgr) {
+    memMgr.GetStats().Reset();
+}
+
 void export_IMEMMANAGER(py::module &m)
 {
     py::class_<IMemoryManager>(m, "IMemoryManager");
@@ -37,5 +91,69 @@ void export_IMEMMANAGER(py::module &m)
         .def("getData", &CustomMemoryManager::getData)
         .def_readonly("m_vBuffers", &CustomMemoryManager::m_vBuffers)
         .def_readonly("m_mapUsedBuffers", &CustomMemoryManager::m_mapUsedBuffers)
-        .def_readonly("m_nBufferSizeInBytes", &CustomMemoryManager::m_nBufferSizeInBytes);
+        .def_readonly("m_nBufferSizeInBytes", &CustomMemoryManager::m_nBufferSizeInBytes)
+        .def("get_stats", &get_stats<CustomMemoryManager>, "Snapshot of the allocation counters")
+        .def("reset_stats", &reset_stats<CustomMemoryManager>, "Clear the allocation counters");
+
+    py::class_<PooledMemoryManager, IMemoryManager>(m, "PooledMemoryManager")
+        .def(py::init<const S_UINT64, const S_UINT32>(), 
+             py::arg("nBufferSizeInBytes") = (512 * 512 * 8), 
+             py::arg("nNumBuffers") = 500)
+        .def("GetBufferSizeInBytes", &PooledMemoryManager::GetBufferSizeInBytes)
+        .def("GetNumberOfBuffers", &PooledMemoryManager::GetNumberOfBuffers)
+        .def("GetNumberOfFreeBuffers", &PooledMemoryManager::GetNumberOfFreeBuffers)
+        .def("get_stats", &get_stats<PooledMemoryManager>, "Snapshot of the allocation counters")
+        .def("reset_stats", &reset_stats<PooledMemoryManager>, "Clear the allocation counters");
+
+    py::class_<SlabSizeClass>(m, "SlabSizeClass")
+        .def(py::init<const S_UINT64, const S_UINT32, const S_UINT32, const S_UINT32>(), 
+             py::arg("nBufferSizeInBytes"), 
+             py::arg("nInitialBuffers") = 0, 
+             py::arg("nMaxBuffers") = 1024, 
+             py::arg("nGrowBy") = 16)
+        .def_readonly("m_nBufferSizeInBytes", &SlabSizeClass::m_nBufferSizeInBytes)
+        .def_readonly("m_nInitialBuffers", &SlabSizeClass::m_nInitialBuffers)
+        .def_readonly("m_nMaxBuffers", &SlabSizeClass::m_nMaxBuffers)
+        .def_readonly("m_nGrowBy", &SlabSizeClass::m_nGrowBy);
+
+    py::class_<SlabPoolMemoryManager, IMemoryManager>(m, "SlabPoolMemoryManager")
+        .def(py::init<const std::vector<SlabSizeClass>&, const bool, const bool>(), 
+             py::arg("vSizeClasses") = SlabPoolMemoryManager::DefaultSizeClasses(), 
+             py::arg("bHugePages") = false, 
+             py::arg("bNumaLocal") = false)
+        .def_static("DefaultSizeClasses", &SlabPoolMemoryManager::DefaultSizeClasses)
+        .def_static("PowerOfTwoSizeClasses", &SlabPoolMemoryManager::PowerOfTwoSizeClasses, 
+                    py::arg("nMinSizeInBytes"), 
+                    py::arg("nMaxSizeInBytes"), 
+                    py::arg("nMaxBuffers") = 1024, 
+                    py::arg("nGrowBy") = 16)
+        .def("Shrink", &SlabPoolMemoryManager::Shrink, py::call_guard<py::gil_scoped_release>(),
+             "Release the slabs whose buffers are all free, returns the number of bytes released")
+        .def("GetSizeClasses", &SlabPoolMemoryManager::GetSizeClasses)
+        .def("GetNumberOfSizeClasses", &SlabPoolMemoryManager::GetNumberOfSizeClasses)
+        .def("GetNumberOfBuffers", &SlabPoolMemoryManager::GetNumberOfBuffers, py::arg("nSizeClass"))
+        .def("GetNumberOfFreeBuffers", &SlabPoolMemoryManager::GetNumberOfFreeBuffers, py::arg("nSizeClass"))
+        .def("get_slab_stats", &get_slab_stats, "Huge pages and NUMA binding actually obtained for the slabs")
+        .def("get_stats", &get_stats<SlabPoolMemoryManager>, "Snapshot of the allocation counters")
+        .def("reset_stats", &reset_stats<SlabPoolMemoryManager>, "Clear the allocation counters");
+
+    py::class_<ArrayMemoryManager, IMemoryManager>(m, "ArrayMemoryManager")
+        .def(py::init([](py::array array, const S_UINT64 nSliceStrideInBytes) {
+                 if (!(array.flags() & py::array::c_style) || !array.writeable())
+                     throw std::runtime_error("Expected a writeable C-contiguous array");
+                 return new ArrayMemoryManager(static_cast<unsigned char*>(array.mutable_data()),
+                                               S_UINT64(array.nbytes()), nSliceStrideInBytes);
+             }), 
+             py::arg("array"), 
+             py::arg("nSliceStrideInBytes") = 0, 
+             py::keep_alive<1, 2>(), 
+             "Decode the slices of the next reads into consecutive regions of the array")
+        .def("Rewind", &ArrayMemoryManager::Rewind, 
+             "Reuse the array from its start, returns False while slices still use it")
+        .def("GetSizeInBytes", &ArrayMemoryManager::GetSizeInBytes)
+        .def("GetSliceStrideInBytes", &ArrayMemoryManager::GetSliceStrideInBytes)
+        .def("GetBytesUsed", &ArrayMemoryManager::GetBytesUsed)
+        .def("GetNumberOfRegionsInUse", &ArrayMemoryManager::GetNumberOfRegionsInUse)
+        .def("get_stats", &get_stats<ArrayMemoryManager>, "Snapshot of the allocation counters")
+        .def("reset_stats", &reset_stats<ArrayMemoryManager>, "Clear the allocation counters");
 }
@@ -0,0 +1,97 @@
+#ifndef MEMORYMANAGERSTATS_FILE_H
+#define MEMORYMANAGERSTATS_FILE_H
+
+#include "SDICOS/DICOS.h" //Header for DICOS
+
+#include <atomic>
+
+using namespace SDICOS;
+
+//Allocation counters of a memory manager. Updating them is a few relaxed atomic operations,
+//so they stay enabled on the allocation path of concurrent reads.
+class MemoryManagerStats
+{
+public:
+	//Bin 0 counts empty requests, bin n > 0 requests of [2^(n-1), 2^n) bytes
+	static const S_UINT32 s_nNumHistogramBins = 65;
+
+	struct Snapshot
+	{
+		S_UINT64 m_nHits; //Requests served by the memory manager
+		S_UINT64 m_nMisses; //Requests left to the DICOS library
+		S_UINT64 m_nDeallocations; //Buffers given back to the memory manager
+		S_UINT64 m_nBytesOutstanding; //Bytes handed out and not given back yet
+		S_UINT64 m_nHighWaterBytes; //Largest m_nBytesOutstanding since the last reset
+		S_UINT64 m_vHistogram[s_nNumHistogramBins]; //Sizes of the requests, hits and misses
+	};
+
+	MemoryManagerStats() { Reset(); }
+
+	MemoryManagerStats(const MemoryManagerStats&) = delete;
+	MemoryManagerStats& operator=(const MemoryManagerStats&) = delete;
+
+	static S_UINT32 GetHistogramBin(S_UINT64 nSizeInBytes)
+	{
+		S_UINT32 nBin(0);
+		for (; nSizeInBytes > 0; nSizeInBytes >>= 1)
+			++nBin;
+		return nBin;
+	}
+
+	void OnHit(const S_UINT64 nSizeInBytes)
+	{
+		m_nHits.fetch_add(1, std::memory_order_relaxed);
+		m_vHistogram[GetHistogramBin(nSizeInBytes)].fetch_add(1, std::memory_order_relaxed);
+
+		const S_UINT64 nOutstanding(m_nBytesOutstanding.fetch_add(nSizeInBytes, std::memory_order_relaxed) + nSizeInBytes);
+		S_UINT64 nHighWater(m_nHighWaterBytes.load(std::memory_order_relaxed));
+		while (nHighWater < nOutstanding &&
+			   !m_nHighWaterBytes.compare_exchange_weak(nHighWater, nOutstanding, std::memory_order_relaxed)) {}
+	}
+
+	void OnMiss(const S_UINT64 nSizeInBytes)
+	{
+		m_nMisses.fetch_add(1, std::memory_order_relaxed);
+		m_vHistogram[GetHistogramBin(nSizeInBytes)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void OnDeallocate(const S_UINT64 nSizeInBytes)
+	{
+		m_nDeallocations.fetch_add(1, std::memory_order_relaxed);
+		m_nBytesOutstanding.fetch_sub(nSizeInBytes, std::memory_order_relaxed);
+	}
+
+	//Each counter is read atomically but the snapshot as a whole is not, allocations may run meanwhile
+	Snapshot GetSnapshot() const
+	{
+		Snapshot snapshot;
+		snapshot.m_nHits = m_nHits.load(std::memory_order_relaxed);
+		snapshot.m_nMisses = m_nMisses.load(std::memory_order_relaxed);
+		snapshot.m_nDeallocations = m_nDeallocations.load(std::memory_order_relaxed);
+		snapshot.m_nBytesOutstanding = m_nBytesOutstanding.load(std::memory_order_relaxed);
+		snapshot.m_nHighWaterBytes = m_nHighWaterBytes.load(std::memory_order_relaxed);
+		for (S_UINT32 n(0); n < s_nNumHistogramBins; ++n)
+			snapshot.m_vHistogram[n] = m_vHistogram[n].load(std::memory_order_relaxed);
+		return snapshot;
+	}
+
+	//Clears the counters. The bytes outstanding are kept and become the new high-water mark.
+	void Reset()
+	{
+		m_nHits.store(0, std::memory_order_relaxed);
+		m_nMisses.store(0, std::memory_order_relaxed);
+		m_nDeallocations.store(0, std::memory_order_relaxed);
+		m_nHighWaterBytes.store(m_nBytesOutstanding.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		for (S_UINT32 n(0); n < s_nNumHistogramBins; ++n)
+			m_vHistogram[n].store(0, std::memory_order_relaxed);
+	}
+
+protected:
+	std::atomic<S_UINT64> m_nHits;
+	std::atomic<S_UINT64> m_nMisses;
+	std::atomic<S_UINT64> m_nDeallocations;
+	std::atomic<S_UINT64> m_nBytesOutstanding{0};
+	std::atomic<S_UINT64> m_nHighWaterBytes;
+	std::atomic<S_UINT64> m_vHistogram[s_nNumHistogramBins];
+};
+#endif
\ No newline at end of file
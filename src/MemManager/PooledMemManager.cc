@@ -0,0 +1,78 @@
+#include "PooledMemManager.hh"
+
+#include <new>
+
+PooledMemoryManager::PooledMemoryManager(const SDICOS::S_UINT64 nBufferSizeInBytes, const SDICOS::S_UINT32 nNumBuffers)
+	: m_nBufferSizeInBytes(nBufferSizeInBytes),
+	  m_nStrideInBytes((nBufferSizeInBytes + s_nAlignment - 1) / s_nAlignment * s_nAlignment),
+	  m_pInUse(new std::atomic<bool>[nNumBuffers > 0 ? nNumBuffers : 1]),
+	  m_pool(nNumBuffers)
+{
+	const SDICOS::S_UINT64 nSlabSize(m_nStrideInBytes * nNumBuffers);
+	m_pSlab.reset(static_cast<unsigned char*>(::operator new[](nSlabSize > 0 ? nSlabSize : 1, std::align_val_t(s_nAlignment))));
+
+	for (SDICOS::S_UINT32 n(0); n < nNumBuffers; ++n)
+		m_pInUse[n].store(false, std::memory_order_relaxed);
+}
+
+PooledMemoryManager::~PooledMemoryManager()
+{
+}
+
+SDICOS::S_UINT32 PooledMemoryManager::IndexOf(const unsigned char* pData) const
+{
+	if (S_NULL == pData || pData < m_pSlab.get() || 0 == m_nStrideInBytes)
+		return LockFreeIndexPool::s_nEmpty;
+
+	const SDICOS::S_UINT64 nOffset(pData - m_pSlab.get());
+	if (0 != nOffset % m_nStrideInBytes || nOffset / m_nStrideInBytes >= m_pool.GetCount())
+		return LockFreeIndexPool::s_nEmpty;
+	return SDICOS::S_UINT32(nOffset / m_nStrideInBytes);
+}
+
+bool PooledMemoryManager::OnAllocate(SDICOS::MemoryBuffer &mbAllocate, const SDICOS::S_UINT64 nSizeInBytesToAllocate)
+{
+	//Too large for a buffer of the pool, let the DICOS library allocate it
+	if (nSizeInBytesToAllocate > m_nBufferSizeInBytes) {
+		m_stats.OnMiss(nSizeInBytesToAllocate);
+		return false;
+	}
+
+	SDICOS::S_UINT32 nIndex;
+	if (!m_pool.Pop(nIndex)) {
+		m_stats.OnMiss(nSizeInBytesToAllocate);
+		return false; //No more buffers available
+	}
+
+	m_pInUse[nIndex].store(true, std::memory_order_relaxed);
+
+	//Even though the buffer may be larger, only state the requested size has been provided
+	mbAllocate.SetBuffer(m_pSlab.get() + nIndex * m_nStrideInBytes, nSizeInBytesToAllocate);
+	m_stats.OnHit(nSizeInBytesToAllocate);
+	return true;
+}
+
+bool PooledMemoryManager::OnDeallocate(SDICOS::MemoryBuffer &mbDeallocate)
+{
+	//If memory policy does not match, then the buffer was not allocated by this class
+	if (GetSliceMemoryPolicy() != mbDeallocate.GetMemoryPolicy())
+		return false;
+
+	const SDICOS::S_UINT32 nIndex(IndexOf(mbDeallocate.GetData()));
+	if (LockFreeIndexPool::s_nEmpty == nIndex)
+		return false;
+
+	//Only the first deallocation of a buffer gives it back to the pool
+	if (!m_pInUse[nIndex].exchange(false, std::memory_order_relaxed))
+		return false;
+
+	m_pool.Push(nIndex);
+	m_stats.OnDeallocate(mbDeallocate.GetSize());
+	return true;
+}
+
+SDICOS::MemoryBuffer::MEMORY_POLICY PooledMemoryManager::OnGetSliceMemoryPolicy()const
+{
+	//Tell the DICOS library it does not own the data, so it never deletes the slab
+	return SDICOS::MemoryBuffer::enumPolicy_DoesNotOwnData;
+}
@@ -0,0 +1,63 @@
+#ifndef POOLEDMEMORYMANAGER_FILE_H
+#define POOLEDMEMORYMANAGER_FILE_H
+
+#include "SDICOS/DICOS.h" //Header for DICOS
+#include "LockFreeIndexPool.hh"
+#include "MemoryManagerStats.hh"
+
+#include <atomic>
+#include <memory>
+
+using namespace SDICOS;
+
+//Memory manager handing out fixed size buffers carved from a single preallocated slab.
+//Free buffers are kept in a lock-free stack and a buffer is found from its address with
+//a division, so allocating and deallocating are O(1), never block and never print.
+//A single instance can be shared by concurrent reads.
+class PooledMemoryManager : public IMemoryManager
+{
+public:
+	static const S_UINT64 s_nAlignment = 64; //Buffers start on a cache line
+
+	//Constructor preallocates the slab holding nNumBuffers buffers of nBufferSizeInBytes
+	PooledMemoryManager(const S_UINT64 nBufferSizeInBytes = (512 * 512 * 8), const S_UINT32 nNumBuffers = 500);
+	virtual ~PooledMemoryManager();
+
+	PooledMemoryManager(const PooledMemoryManager&) = delete;
+	PooledMemoryManager& operator=(const PooledMemoryManager&) = delete;
+
+	//Provides a free buffer if the requested size fits in one. Returns false, letting the DICOS
+	//library allocate the memory itself, if the request is too large or the pool is exhausted.
+	virtual bool OnAllocate(MemoryBuffer &mbAllocate, const S_UINT64 nSizeInBytesToAllocate);
+
+	//Gives the buffer back to the pool. Returns false for buffers that do not come from the pool.
+	virtual bool OnDeallocate(MemoryBuffer &mbDeallocate);
+
+	//The pool owns the buffers, the DICOS library only borrows them
+	virtual MemoryBuffer::MEMORY_POLICY OnGetSliceMemoryPolicy()const;
+
+	S_UINT64 GetBufferSizeInBytes() const { return m_nBufferSizeInBytes; }
+	S_UINT32 GetNumberOfBuffers() const { return m_pool.GetCount(); }
+	S_UINT32 GetNumberOfFreeBuffers() const { return m_pool.GetNumberOfFree(); }
+
+	//Index of the buffer starting at pData, or LockFreeIndexPool::s_nEmpty if it is not one of the pool
+	S_UINT32 IndexOf(const unsigned char* pData) const;
+
+	//Allocation counters of the memory manager
+	MemoryManagerStats& GetStats() { return m_stats; }
+	const MemoryManagerStats& GetStats() const { return m_stats; }
+
+protected:
+	struct AlignedDelete
+	{
+		void operator()(unsigned char* p) const { ::operator delete[](p, std::align_val_t(s_nAlignment)); }
+	};
+
+	const S_UINT64										m_nBufferSizeInBytes; //Size of each buffer as requested
+	const S_UINT64										m_nStrideInBytes; //Distance between two buffers in the slab
+	std::unique_ptr<unsigned char[], AlignedDelete>		m_pSlab;
+	std::unique_ptr<std::atomic<bool>[]>				m_pInUse; //Guards against foreign and double deallocations
+	LockFreeIndexPool									m_pool;
+	MemoryManagerStats									m_stats;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "SlabMemory.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define SLABMEMORY_MPOL_BIND 2 //MPOL_BIND from linux/mempolicy.h, libnuma is not required
+#endif
+
+namespace
+{
+	//Huge page size from /proc/meminfo, 2 MiB when it is not available
+	S_UINT64 ReadHugePageSize()
+	{
+		std::ifstream meminfo("/proc/meminfo");
+		std::string strLine;
+		while (std::getline(meminfo, strLine)) {
+			if (0 != strLine.compare(0, 13, "Hugepagesize:"))
+				continue;
+			std::istringstream line(strLine.substr(13));
+			S_UINT64 nSizeInKB(0);
+			if (line >> nSizeInKB && nSizeInKB > 0)
+				return nSizeInKB * 1024;
+		}
+		return 2 * 1024 * 1024;
+	}
+}
+
+SlabMemory::SlabMemory(const bool bHugePages, const bool bNumaLocal)
+	: m_bHugePages(bHugePages), m_bNumaLocal(bNumaLocal), m_nHugePageSizeInBytes(0),
+	  m_nSlabBytes(0), m_nHugeTlbBytes(0), m_nMadvisedBytes(0), m_nNumaBoundBytes(0), m_nNumaNode(-1)
+{
+#ifdef __linux__
+	if (m_bHugePages)
+		m_nHugePageSizeInBytes = ReadHugePageSize();
+#endif
+}
+
+SlabMemory::~SlabMemory()
+{
+}
+
+Slab SlabMemory::Allocate(const S_UINT64 nSizeInBytes)
+{
+	Slab slab;
+	const S_UINT64 nSize(nSizeInBytes > 0 ? nSizeInBytes : 1);
+
+#ifdef __linux__
+	//A smaller slab would waste most of its huge page
+	const bool bHugePages(m_bHugePages && nSize >= m_nHugePageSizeInBytes);
+	if (bHugePages || m_bNumaLocal) {
+		//Explicit huge pages only exist if the administrator reserved some
+		if (bHugePages) {
+			const S_UINT64 nMappingSize((nSize + m_nHugePageSizeInBytes - 1) / m_nHugePageSizeInBytes * m_nHugePageSizeInBytes);
+			void* pMapping = mmap(S_NULL, nMappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (MAP_FAILED != pMapping) {
+				slab.m_pMapping = pMapping;
+				slab.m_nMappingSizeInBytes = nMappingSize;
+				slab.m_bHugeTlb = true;
+			}
+		}
+
+		//Regular pages, aligned on a huge page so transparent huge pages can back the whole slab
+		if (S_NULL == slab.m_pMapping) {
+			const S_UINT64 nAlignment(bHugePages ? m_nHugePageSizeInBytes : S_UINT64(sysconf(_SC_PAGESIZE)));
+			const S_UINT64 nMappingSize((nSize + nAlignment - 1) / nAlignment * nAlignment);
+			void* pMapping = mmap(S_NULL, nMappingSize + nAlignment, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (MAP_FAILED == pMapping)
+				return slab;
+
+			//Trim the mapping to an aligned range
+			const std::uintptr_t nMapping(reinterpret_cast<std::uintptr_t>(pMapping));
+			const std::uintptr_t nAligned((nMapping + nAlignment - 1) / nAlignment * nAlignment);
+			if (nAligned > nMapping)
+				munmap(pMapping, nAligned - nMapping);
+			if (nMapping + nAlignment > nAligned)
+				munmap(reinterpret_cast<void*>(nAligned + nMappingSize), nMapping + nAlignment - nAligned);
+
+			slab.m_pMapping = reinterpret_cast<void*>(nAligned);
+			slab.m_nMappingSizeInBytes = nMappingSize;
+
+			if (bHugePages && 0 == madvise(slab.m_pMapping, nMappingSize, MADV_HUGEPAGE)) {
+				m_nMadvisedBytes.fetch_add(nMappingSize, std::memory_order_relaxed);
+				std::lock_guard<std::mutex> lock(m_mutexMadvised);
+				m_mapMadvised[nAligned] = nMappingSize;
+			}
+		}
+		slab.m_pData = static_cast<unsigned char*>(slab.m_pMapping);
+
+		//Bind before the first touch so the pages are faulted in on the node of this thread
+		unsigned int nCpu(0), nNode(0);
+		if (m_bNumaLocal && 0 == syscall(SYS_getcpu, &nCpu, &nNode, S_NULL)) {
+			unsigned long vNodeMask[16] = {0};
+			const unsigned long nBitsPerWord(8 * sizeof(unsigned long));
+			if (nNode < 16 * nBitsPerWord) {
+				vNodeMask[nNode / nBitsPerWord] = 1UL << (nNode % nBitsPerWord);
+				if (0 == syscall(SYS_mbind, slab.m_pMapping, slab.m_nMappingSizeInBytes, SLABMEMORY_MPOL_BIND,
+								 vNodeMask, 16 * nBitsPerWord + 1, 0)) {
+					m_nNumaBoundBytes.fetch_add(slab.m_nMappingSizeInBytes, std::memory_order_relaxed);
+					m_nNumaNode.store(S_INT32(nNode), std::memory_order_relaxed);
+				}
+			}
+		}
+
+		if (slab.m_bHugeTlb)
+			m_nHugeTlbBytes.fetch_add(slab.m_nMappingSizeInBytes, std::memory_order_relaxed);
+		m_nSlabBytes.fetch_add(slab.m_nMappingSizeInBytes, std::memory_order_relaxed);
+		return slab;
+	}
+#endif
+
+	slab.m_pData = static_cast<unsigned char*>(::operator new[](nSize, std::align_val_t(s_nAlignment), std::nothrow));
+	if (S_NULL != slab.m_pData)
+		m_nSlabBytes.fetch_add(nSize, std::memory_order_relaxed);
+	slab.m_nMappingSizeInBytes = nSize;
+	return slab;
+}
+
+void SlabMemory::Free(Slab &slab)
+{
+	if (S_NULL == slab.m_pData)
+		return;
+
+	m_nSlabBytes.fetch_sub(slab.m_nMappingSizeInBytes, std::memory_order_relaxed);
+	if (S_NULL == slab.m_pMapping) {
+		::operator delete[](slab.m_pData, std::align_val_t(s_nAlignment));
+		slab = Slab();
+		return;
+	}
+
+#ifdef __linux__
+	if (slab.m_bHugeTlb)
+		m_nHugeTlbBytes.fetch_sub(slab.m_nMappingSizeInBytes, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(m_mutexMadvised);
+		if (m_mapMadvised.erase(reinterpret_cast<std::uintptr_t>(slab.m_pMapping)) > 0)
+			m_nMadvisedBytes.fetch_sub(slab.m_nMappingSizeInBytes, std::memory_order_relaxed);
+	}
+	munmap(slab.m_pMapping, slab.m_nMappingSizeInBytes);
+#endif
+	slab = Slab();
+}
+
+SlabMemory::Stats SlabMemory::GetStats() const
+{
+	Stats stats;
+	stats.m_nSlabBytes = m_nSlabBytes.load(std::memory_order_relaxed);
+	stats.m_nHugeTlbBytes = m_nHugeTlbBytes.load(std::memory_order_relaxed);
+	stats.m_nMadvisedBytes = m_nMadvisedBytes.load(std::memory_order_relaxed);
+	stats.m_nNumaBoundBytes = m_nNumaBoundBytes.load(std::memory_order_relaxed);
+	stats.m_nNumaNode = m_nNumaNode.load(std::memory_order_relaxed);
+	return stats;
+}
+
+S_UINT64 SlabMemory::QueryTransparentHugePageBytes() const
+{
+	std::map<S_UINT64, S_UINT64> mapMadvised;
+	{
+		std::lock_guard<std::mutex> lock(m_mutexMadvised);
+		mapMadvised = m_mapMadvised;
+	}
+	if (mapMadvised.empty())
+		return 0;
+
+	//Each mapping of smaps starts with "start-end perms ...", followed by "Key: value kB" lines.
+	//The kernel may merge a slab with neighbouring mappings, so a mapping counts for at most the bytes it
+	//shares with slabs: its huge pages may back the neighbours too.
+	std::ifstream smaps("/proc/self/smaps");
+	std::string strLine;
+	S_UINT64 nOverlap(0);
+	S_UINT64 nBytes(0);
+	while (std::getline(smaps, strLine)) {
+		const std::string::size_type nDash(strLine.find('-'));
+		const std::string::size_type nColon(strLine.find(':'));
+		if (std::string::npos != nDash && (std::string::npos == nColon || nDash < nColon) &&
+			std::string::npos == strLine.substr(0, nDash).find_first_not_of("0123456789abcdef")) {
+			S_UINT64 nStart(0), nEnd(0);
+			std::istringstream(strLine.substr(0, nDash)) >> std::hex >> nStart;
+			std::istringstream(strLine.substr(nDash + 1)) >> std::hex >> nEnd;
+			nOverlap = 0;
+			std::map<S_UINT64, S_UINT64>::const_iterator it = mapMadvised.upper_bound(nStart);
+			if (mapMadvised.begin() != it)
+				--it;
+			for (; mapMadvised.end() != it && it->first < nEnd; ++it) {
+				const S_UINT64 nFrom(it->first > nStart ? it->first : nStart);
+				const S_UINT64 nTo(it->first + it->second < nEnd ? it->first + it->second : nEnd);
+				if (nTo > nFrom)
+					nOverlap += nTo - nFrom;
+			}
+		}
+		else if (nOverlap > 0 && 0 == strLine.compare(0, 14, "AnonHugePages:")) {
+			std::istringstream line(strLine.substr(14));
+			S_UINT64 nSizeInKB(0);
+			if (line >> nSizeInKB)
+				nBytes += nSizeInKB * 1024 < nOverlap ? nSizeInKB * 1024 : nOverlap;
+		}
+	}
+	return nBytes;
+}
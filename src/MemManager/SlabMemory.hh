@@ -0,0 +1,75 @@
+#ifndef SLABMEMORY_FILE_H
+#define SLABMEMORY_FILE_H
+
+#include "SDICOS/DICOS.h" //Header for DICOS
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+using namespace SDICOS;
+
+//Memory of one slab and how it was obtained
+struct Slab
+{
+	Slab() : m_pData(S_NULL), m_pMapping(S_NULL), m_nMappingSizeInBytes(0), m_bHugeTlb(false) {}
+
+	unsigned char*	m_pData; //Start of the usable memory
+	void*			m_pMapping; //S_NULL if the slab comes from operator new
+	S_UINT64		m_nMappingSizeInBytes;
+	bool			m_bHugeTlb; //Backed by explicit huge pages (MAP_HUGETLB)
+};
+
+//Allocates the slabs of the pooled memory managers.
+//On Linux slabs can be backed by huge pages and bound to the NUMA node of the thread allocating them:
+//explicit huge pages (MAP_HUGETLB) are tried first, then transparent huge pages are requested with madvise.
+//Only slabs of at least one huge page use huge pages, smaller slabs would be rounded up to one.
+//Elsewhere, or when the options are off, slabs are cache line aligned blocks from operator new.
+class SlabMemory
+{
+public:
+	static const S_UINT64 s_nAlignment = 64;
+
+	struct Stats
+	{
+		S_UINT64	m_nSlabBytes; //Bytes of all slabs
+		S_UINT64	m_nHugeTlbBytes; //Bytes backed by explicit huge pages
+		S_UINT64	m_nMadvisedBytes; //Bytes for which transparent huge pages were requested
+		S_UINT64	m_nNumaBoundBytes; //Bytes bound to a NUMA node
+		S_INT32		m_nNumaNode; //Node of the last bound slab, -1 if none
+	};
+
+	SlabMemory(const bool bHugePages = false, const bool bNumaLocal = false);
+	~SlabMemory();
+
+	SlabMemory(const SlabMemory&) = delete;
+	SlabMemory& operator=(const SlabMemory&) = delete;
+
+	//Returns a slab with m_pData = S_NULL if the memory could not be obtained
+	Slab Allocate(const S_UINT64 nSizeInBytes);
+	void Free(Slab &slab);
+
+	bool IsUsingHugePages() const { return m_bHugePages; }
+	bool IsNumaLocal() const { return m_bNumaLocal; }
+	S_UINT64 GetHugePageSizeInBytes() const { return m_nHugePageSizeInBytes; }
+
+	Stats GetStats() const;
+
+	//Bytes of the madvised slabs the kernel currently backs with transparent huge pages, at most the madvised bytes.
+	//Reads /proc/self/smaps, so it is meant for monitoring rather than the allocation path.
+	S_UINT64 QueryTransparentHugePageBytes() const;
+
+protected:
+	const bool					m_bHugePages;
+	const bool					m_bNumaLocal;
+	S_UINT64					m_nHugePageSizeInBytes;
+	std::atomic<S_UINT64>		m_nSlabBytes;
+	std::atomic<S_UINT64>		m_nHugeTlbBytes;
+	std::atomic<S_UINT64>		m_nMadvisedBytes;
+	std::atomic<S_UINT64>		m_nNumaBoundBytes;
+	std::atomic<S_INT32>		m_nNumaNode;
+
+	mutable std::mutex			m_mutexMadvised;
+	std::map<S_UINT64, S_UINT64> m_mapMadvised; //Start and size of the madvised slabs
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include "SlabPoolMemManager.hh"
+
+#include <algorithm>
+#include <cstdint>
+
+SlabSizeClassPool::SlabSizeClassPool(const SlabSizeClass &sizeClass, SlabMemory &slabMemory)
+	: m_sizeClass(sizeClass),
+	  m_slabMemory(slabMemory),
+	  m_nStrideInBytes((sizeClass.m_nBufferSizeInBytes + s_nAlignment - 1) / s_nAlignment * s_nAlignment),
+	  m_nNumSlabs((sizeClass.m_nMaxBuffers + sizeClass.m_nGrowBy - 1) / sizeClass.m_nGrowBy),
+	  m_pSlabs(new std::atomic<unsigned char*>[m_nNumSlabs > 0 ? m_nNumSlabs : 1]),
+	  m_pSlabMemory(new Slab[m_nNumSlabs > 0 ? m_nNumSlabs : 1]),
+	  m_pInUse(new std::atomic<bool>[sizeClass.m_nMaxBuffers > 0 ? sizeClass.m_nMaxBuffers : 1]),
+	  m_nNumBuffers(0),
+	  m_pool(sizeClass.m_nMaxBuffers, 0)
+{
+	for (S_UINT32 n(0); n < m_nNumSlabs; ++n)
+		m_pSlabs[n].store(S_NULL, std::memory_order_relaxed);
+	for (S_UINT32 n(0); n < sizeClass.m_nMaxBuffers; ++n)
+		m_pInUse[n].store(false, std::memory_order_relaxed);
+
+	while (GetNumberOfBuffers() < std::min(sizeClass.m_nInitialBuffers, sizeClass.m_nMaxBuffers) && AddSlab()) {}
+}
+
+SlabSizeClassPool::~SlabSizeClassPool()
+{
+	for (S_UINT32 n(0); n < m_nNumSlabs; ++n)
+		m_slabMemory.Free(m_pSlabMemory[n]);
+}
+
+S_UINT32 SlabSizeClassPool::GetSlabSize(const S_UINT32 nSlab) const
+{
+	return std::min(m_sizeClass.m_nGrowBy, m_sizeClass.m_nMaxBuffers - nSlab * m_sizeClass.m_nGrowBy);
+}
+
+bool SlabSizeClassPool::Grow()
+{
+	std::lock_guard<std::mutex> lock(m_mutexResize);
+
+	//Another thread grew the class while this one waited
+	if (m_pool.GetNumberOfFree() > 0)
+		return true;
+	return AddSlab();
+}
+
+bool SlabSizeClassPool::AddSlab()
+{
+	for (S_UINT32 nSlab(0); nSlab < m_nNumSlabs; ++nSlab) {
+		if (S_NULL != m_pSlabs[nSlab].load(std::memory_order_relaxed))
+			continue;
+
+		const S_UINT32 nSlabSize(GetSlabSize(nSlab));
+		m_pSlabMemory[nSlab] = m_slabMemory.Allocate(m_nStrideInBytes * nSlabSize);
+		if (S_NULL == m_pSlabMemory[nSlab].m_pData)
+			return false;
+
+		m_pSlabs[nSlab].store(m_pSlabMemory[nSlab].m_pData, std::memory_order_release);
+		m_nNumBuffers.fetch_add(nSlabSize, std::memory_order_relaxed);
+
+		//Pushed in reverse so the lowest addresses are handed out first
+		for (S_UINT32 n(nSlabSize); n > 0; --n)
+			m_pool.Push(nSlab * m_sizeClass.m_nGrowBy + n - 1);
+		return true;
+	}
+	return false; //Maximum size reached
+}
+
+S_UINT64 SlabSizeClassPool::Shrink()
+{
+	std::lock_guard<std::mutex> lock(m_mutexResize);
+
+	//Take all free buffers out of the pool so none of the released slabs can be handed out
+	std::vector<S_UINT32> vFree;
+	std::vector<S_UINT32> vNumFreePerSlab(m_nNumSlabs, 0);
+	S_UINT32 nIndex;
+	while (m_pool.Pop(nIndex)) {
+		vFree.push_back(nIndex);
+		++vNumFreePerSlab[nIndex / m_sizeClass.m_nGrowBy];
+	}
+
+	const S_UINT32 nNumInitialSlabs((m_sizeClass.m_nInitialBuffers + m_sizeClass.m_nGrowBy - 1) / m_sizeClass.m_nGrowBy);
+	S_UINT64 nReleased(0);
+	for (S_UINT32 nSlab(nNumInitialSlabs); nSlab < m_nNumSlabs; ++nSlab) {
+		const S_UINT32 nSlabSize(GetSlabSize(nSlab));
+		if (vNumFreePerSlab[nSlab] != nSlabSize)
+			continue;
+
+		m_pSlabs[nSlab].store(S_NULL, std::memory_order_release);
+		m_slabMemory.Free(m_pSlabMemory[nSlab]);
+		m_nNumBuffers.fetch_sub(nSlabSize, std::memory_order_relaxed);
+		nReleased += m_nStrideInBytes * nSlabSize;
+		vNumFreePerSlab[nSlab] = 0; //Marks the buffers of the slab as gone
+	}
+
+	for (std::vector<S_UINT32>::const_reverse_iterator it = vFree.rbegin(); it != vFree.rend(); ++it) {
+		if (vNumFreePerSlab[*it / m_sizeClass.m_nGrowBy] > 0)
+			m_pool.Push(*it);
+	}
+	return nReleased;
+}
+
+S_UINT32 SlabSizeClassPool::IndexOf(const unsigned char* pData) const
+{
+	if (S_NULL == pData || 0 == m_nStrideInBytes)
+		return LockFreeIndexPool::s_nEmpty;
+
+	const std::uintptr_t nData(reinterpret_cast<std::uintptr_t>(pData));
+	for (S_UINT32 nSlab(0); nSlab < m_nNumSlabs; ++nSlab) {
+		const std::uintptr_t nSlabStart(reinterpret_cast<std::uintptr_t>(m_pSlabs[nSlab].load(std::memory_order_acquire)));
+		if (0 == nSlabStart || nData < nSlabStart || nData >= nSlabStart + m_nStrideInBytes * GetSlabSize(nSlab))
+			continue;
+
+		const S_UINT64 nOffset(nData - nSlabStart);
+		if (0 != nOffset % m_nStrideInBytes)
+			return LockFreeIndexPool::s_nEmpty;
+		return nSlab * m_sizeClass.m_nGrowBy + S_UINT32(nOffset / m_nStrideInBytes);
+	}
+	return LockFreeIndexPool::s_nEmpty;
+}
+
+unsigned char* SlabSizeClassPool::Allocate()
+{
+	S_UINT32 nIndex;
+	while (!m_pool.Pop(nIndex)) {
+		if (!Grow())
+			return S_NULL; //No more buffers available
+	}
+
+	m_pInUse[nIndex].store(true, std::memory_order_relaxed);
+	const S_UINT32 nSlab(nIndex / m_sizeClass.m_nGrowBy);
+	return m_pSlabs[nSlab].load(std::memory_order_acquire) + S_UINT64(nIndex % m_sizeClass.m_nGrowBy) * m_nStrideInBytes;
+}
+
+bool SlabSizeClassPool::Deallocate(const unsigned char* pData)
+{
+	const S_UINT32 nIndex(IndexOf(pData));
+	if (LockFreeIndexPool::s_nEmpty == nIndex)
+		return false;
+
+	//Only the first deallocation of a buffer gives it back to the pool
+	if (!m_pInUse[nIndex].exchange(false, std::memory_order_relaxed))
+		return false;
+
+	m_pool.Push(nIndex);
+	return true;
+}
+
+SlabPoolMemoryManager::SlabPoolMemoryManager(const std::vector<SlabSizeClass> &vSizeClasses, const bool bHugePages, const bool bNumaLocal)
+	: m_slabMemory(bHugePages, bNumaLocal)
+{
+	std::vector<SlabSizeClass> vSorted(vSizeClasses);
+	std::stable_sort(vSorted.begin(), vSorted.end(), [](const SlabSizeClass &a, const SlabSizeClass &b) {
+		return a.m_nBufferSizeInBytes < b.m_nBufferSizeInBytes;
+	});
+
+	for (const SlabSizeClass &sizeClass : vSorted) {
+		//The first class of a given size wins
+		if (0 == sizeClass.m_nBufferSizeInBytes ||
+			(!m_vPools.empty() && m_vPools.back()->GetBufferSizeInBytes() == sizeClass.m_nBufferSizeInBytes))
+			continue;
+		m_vPools.emplace_back(new SlabSizeClassPool(sizeClass, m_slabMemory));
+	}
+}
+
+SlabPoolMemoryManager::~SlabPoolMemoryManager()
+{
+}
+
+std::vector<SlabSizeClass> SlabPoolMemoryManager::DefaultSizeClasses()
+{
+	std::vector<SlabSizeClass> vSizeClasses;
+	for (S_UINT64 nSide : {512, 768, 1024}) {
+		for (S_UINT64 nBytesPerPixel : {1, 2, 4})
+			vSizeClasses.push_back(SlabSizeClass(nSide * nSide * nBytesPerPixel));
+	}
+	return vSizeClasses;
+}
+
+std::vector<SlabSizeClass> SlabPoolMemoryManager::PowerOfTwoSizeClasses(const S_UINT64 nMinSizeInBytes, const S_UINT64 nMaxSizeInBytes,
+																		const S_UINT32 nMaxBuffers, const S_UINT32 nGrowBy)
+{
+	const S_UINT32 nMinMaxBuffers(std::min<S_UINT32>(nMaxBuffers, 16));
+	std::vector<SlabSizeClass> vSizeClasses;
+	S_UINT64 nSize(nMinSizeInBytes > 0 ? nMinSizeInBytes : 1);
+	S_UINT32 nClassMaxBuffers(nMaxBuffers), nClassGrowBy(nGrowBy > 0 ? nGrowBy : 1);
+	for (; nSize < nMaxSizeInBytes; nSize *= 2) {
+		vSizeClasses.push_back(SlabSizeClass(nSize, 0, nClassMaxBuffers, nClassGrowBy));
+		nClassMaxBuffers = std::max(nClassMaxBuffers / 2, nMinMaxBuffers);
+		nClassGrowBy = std::max<S_UINT32>(nClassGrowBy / 2, 1);
+	}
+	vSizeClasses.push_back(SlabSizeClass(nMaxSizeInBytes > 0 ? nMaxSizeInBytes : nSize, 0, nClassMaxBuffers, nClassGrowBy));
+	return vSizeClasses;
+}
+
+S_UINT32 SlabPoolMemoryManager::FindSizeClass(const S_UINT64 nSizeInBytes) const
+{
+	std::vector<std::unique_ptr<SlabSizeClassPool>>::const_iterator it = std::lower_bound(
+		m_vPools.begin(), m_vPools.end(), nSizeInBytes,
+		[](const std::unique_ptr<SlabSizeClassPool> &pPool, const S_UINT64 nSize) {
+			return pPool->GetBufferSizeInBytes() < nSize;
+		});
+	return S_UINT32(it - m_vPools.begin());
+}
+
+bool SlabPoolMemoryManager::OnAllocate(MemoryBuffer &mbAllocate, const S_UINT64 nSizeInBytesToAllocate)
+{
+	const S_UINT32 nSizeClass(FindSizeClass(nSizeInBytesToAllocate));
+	unsigned char* pData = nSizeClass < m_vPools.size() ? m_vPools[nSizeClass]->Allocate() : S_NULL;
+	if (S_NULL == pData) {
+		//Too large for all classes or class full, let the DICOS library allocate it
+		m_stats.OnMiss(nSizeInBytesToAllocate);
+		return false;
+	}
+
+	//Even though the buffer may be larger, only state the requested size has been provided
+	mbAllocate.SetBuffer(pData, nSizeInBytesToAllocate);
+	m_stats.OnHit(nSizeInBytesToAllocate);
+	return true;
+}
+
+bool SlabPoolMemoryManager::OnDeallocate(MemoryBuffer &mbDeallocate)
+{
+	//If memory policy does not match, then the buffer was not allocated by this class
+	if (GetSliceMemoryPolicy() != mbDeallocate.GetMemoryPolicy())
+		return false;
+
+	//The buffer normally comes from the class matching its size, the others are only searched as a fallback
+	const S_UINT32 nSizeClass(FindSizeClass(mbDeallocate.GetSize()));
+	bool bDeallocated(nSizeClass < m_vPools.size() && m_vPools[nSizeClass]->Deallocate(mbDeallocate.GetData()));
+	for (S_UINT32 n(0); !bDeallocated && n < m_vPools.size(); ++n)
+		bDeallocated = n != nSizeClass && m_vPools[n]->Deallocate(mbDeallocate.GetData());
+
+	if (bDeallocated)
+		m_stats.OnDeallocate(mbDeallocate.GetSize());
+	return bDeallocated;
+}
+
+MemoryBuffer::MEMORY_POLICY SlabPoolMemoryManager::OnGetSliceMemoryPolicy()const
+{
+	//Tell the DICOS library it does not own the data, so it never deletes the slabs
+	return MemoryBuffer::enumPolicy_DoesNotOwnData;
+}
+
+S_UINT64 SlabPoolMemoryManager::Shrink()
+{
+	S_UINT64 nReleased(0);
+	for (const std::unique_ptr<SlabSizeClassPool> &pPool : m_vPools)
+		nReleased += pPool->Shrink();
+	return nReleased;
+}
+
+std::vector<SlabSizeClass> SlabPoolMemoryManager::GetSizeClasses() const
+{
+	std::vector<SlabSizeClass> vSizeClasses;
+	for (const std::unique_ptr<SlabSizeClassPool> &pPool : m_vPools)
+		vSizeClasses.push_back(pPool->GetSizeClass());
+	return vSizeClasses;
+}
+
+S_UINT32 SlabPoolMemoryManager::GetNumberOfBuffers(const S_UINT32 nSizeClass) const
+{
+	return nSizeClass < m_vPools.size() ? m_vPools[nSizeClass]->GetNumberOfBuffers() : 0;
+}
+
+S_UINT32 SlabPoolMemoryManager::GetNumberOfFreeBuffers(const S_UINT32 nSizeClass) const
+{
+	return nSizeClass < m_vPools.size() ? m_vPools[nSizeClass]->GetNumberOfFreeBuffers() : 0;
+}
@@ -0,0 +1,141 @@
+#ifndef SLABPOOLMEMORYMANAGER_FILE_H
+#define SLABPOOLMEMORYMANAGER_FILE_H
+
+#include "SDICOS/DICOS.h" //Header for DICOS
+#include "LockFreeIndexPool.hh"
+#include "MemoryManagerStats.hh"
+#include "SlabMemory.hh"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace SDICOS;
+
+//Configuration of one size class of a SlabPoolMemoryManager
+struct SlabSizeClass
+{
+	SlabSizeClass(const S_UINT64 nBufferSizeInBytes = 0, const S_UINT32 nInitialBuffers = 0,
+				  const S_UINT32 nMaxBuffers = 1024, const S_UINT32 nGrowBy = 16)
+		: m_nBufferSizeInBytes(nBufferSizeInBytes), m_nInitialBuffers(nInitialBuffers),
+		  m_nMaxBuffers(nMaxBuffers), m_nGrowBy(nGrowBy > 0 ? nGrowBy : 1) {}
+
+	S_UINT64 m_nBufferSizeInBytes; //Largest request served by the class
+	S_UINT32 m_nInitialBuffers; //Buffers allocated up front, never released by Shrink
+	S_UINT32 m_nMaxBuffers; //Requests beyond this many buffers fall back to the DICOS library
+	S_UINT32 m_nGrowBy; //Buffers added by each slab when the class runs out
+};
+
+//Buffers of a single size class, carved from slabs of m_nGrowBy buffers.
+//Allocate and Deallocate are lock-free, only growing and shrinking take a lock.
+class SlabSizeClassPool
+{
+public:
+	static const S_UINT64 s_nAlignment = 64; //Buffers start on a cache line
+
+	//The slabs are obtained from slabMemory, which must outlive the pool
+	SlabSizeClassPool(const SlabSizeClass &sizeClass, SlabMemory &slabMemory);
+	~SlabSizeClassPool();
+
+	SlabSizeClassPool(const SlabSizeClassPool&) = delete;
+	SlabSizeClassPool& operator=(const SlabSizeClassPool&) = delete;
+
+	//Returns a free buffer, growing the class if needed. Returns S_NULL once m_nMaxBuffers are in use.
+	unsigned char* Allocate();
+
+	//Returns false if pData is not a buffer of this class in use
+	bool Deallocate(const unsigned char* pData);
+
+	//Releases the slabs above the initial ones whose buffers are all free. Returns the number of bytes released.
+	//Allocations running out of buffers while the class shrinks wait for it to finish.
+	S_UINT64 Shrink();
+
+	const SlabSizeClass& GetSizeClass() const { return m_sizeClass; }
+	S_UINT64 GetBufferSizeInBytes() const { return m_sizeClass.m_nBufferSizeInBytes; }
+	S_UINT32 GetNumberOfBuffers() const { return m_nNumBuffers.load(std::memory_order_relaxed); }
+	S_UINT32 GetNumberOfFreeBuffers() const { return m_pool.GetNumberOfFree(); }
+
+protected:
+	//Adds a slab to the class. Returns false if the class is already at its maximum size.
+	bool Grow();
+
+	//Allocates the first missing slab and makes its buffers available. Expects m_mutexResize to be held.
+	bool AddSlab();
+
+	//Index of the buffer starting at pData, or LockFreeIndexPool::s_nEmpty if it is not one of the class
+	S_UINT32 IndexOf(const unsigned char* pData) const;
+
+	S_UINT32 GetSlabSize(const S_UINT32 nSlab) const;
+
+	const SlabSizeClass								m_sizeClass;
+	SlabMemory&										m_slabMemory;
+	const S_UINT64									m_nStrideInBytes; //Distance between two buffers in a slab
+	const S_UINT32									m_nNumSlabs; //Number of slabs at the maximum size
+	std::unique_ptr<std::atomic<unsigned char*>[]>	m_pSlabs; //S_NULL for slabs not allocated
+	std::unique_ptr<Slab[]>							m_pSlabMemory; //How each slab was obtained, guarded by m_mutexResize
+	std::unique_ptr<std::atomic<bool>[]>			m_pInUse; //Guards against foreign and double deallocations
+	std::atomic<S_UINT32>							m_nNumBuffers; //Buffers in the allocated slabs
+	LockFreeIndexPool								m_pool;
+	std::mutex										m_mutexResize;
+};
+
+//Memory manager serving each request from the smallest size class it fits in.
+//Each class grows by whole slabs up to its maximum, so once the pool has warmed up
+//reads do not allocate any memory. A single instance can be shared by concurrent reads.
+class SlabPoolMemoryManager : public IMemoryManager
+{
+public:
+	//bHugePages backs the slabs with huge pages and bNumaLocal binds each slab to the NUMA node of the
+	//thread allocating it, when the system allows it (Linux only). See SlabMemory.
+	SlabPoolMemoryManager(const std::vector<SlabSizeClass> &vSizeClasses = DefaultSizeClasses(),
+						  const bool bHugePages = false, const bool bNumaLocal = false);
+	virtual ~SlabPoolMemoryManager();
+
+	SlabPoolMemoryManager(const SlabPoolMemoryManager&) = delete;
+	SlabPoolMemoryManager& operator=(const SlabPoolMemoryManager&) = delete;
+
+	//Size classes for 512x512, 768x768 and 1024x1024 slices of 8, 16 and 32 bit pixels
+	static std::vector<SlabSizeClass> DefaultSizeClasses();
+
+	//Size classes doubling from nMinSizeInBytes up to nMaxSizeInBytes, for requests of arbitrary sizes.
+	//nMaxBuffers and nGrowBy are those of the smallest class and halve with each doubling, so every class
+	//holds about the same number of bytes, down to 16 buffers grown one at a time.
+	static std::vector<SlabSizeClass> PowerOfTwoSizeClasses(const S_UINT64 nMinSizeInBytes, const S_UINT64 nMaxSizeInBytes,
+															const S_UINT32 nMaxBuffers = 1024, const S_UINT32 nGrowBy = 16);
+
+	//Provides a buffer from the smallest size class the request fits in. Returns false, letting the DICOS
+	//library allocate the memory itself, if the request is larger than all classes or its class is full.
+	virtual bool OnAllocate(MemoryBuffer &mbAllocate, const S_UINT64 nSizeInBytesToAllocate);
+
+	//Gives the buffer back to its size class. Returns false for buffers that do not come from the pool.
+	virtual bool OnDeallocate(MemoryBuffer &mbDeallocate);
+
+	//The pool owns the buffers, the DICOS library only borrows them
+	virtual MemoryBuffer::MEMORY_POLICY OnGetSliceMemoryPolicy()const;
+
+	//Releases the free slabs of every size class. Returns the number of bytes released.
+	S_UINT64 Shrink();
+
+	//Size classes sorted by buffer size
+	std::vector<SlabSizeClass> GetSizeClasses() const;
+	S_UINT32 GetNumberOfSizeClasses() const { return S_UINT32(m_vPools.size()); }
+	S_UINT32 GetNumberOfBuffers(const S_UINT32 nSizeClass) const;
+	S_UINT32 GetNumberOfFreeBuffers(const S_UINT32 nSizeClass) const;
+
+	//Where the slabs come from, and whether huge pages and NUMA binding were obtained
+	const SlabMemory& GetSlabMemory() const { return m_slabMemory; }
+
+	//Allocation counters of the memory manager
+	MemoryManagerStats& GetStats() { return m_stats; }
+	const MemoryManagerStats& GetStats() const { return m_stats; }
+
+protected:
+	//Index of the smallest size class holding nSizeInBytes, or the number of classes if none does
+	S_UINT32 FindSizeClass(const S_UINT64 nSizeInBytes) const;
+
+	SlabMemory										m_slabMemory; //Declared first, the pools free their slabs into it
+	std::vector<std::unique_ptr<SlabSizeClassPool>> m_vPools;
+	MemoryManagerStats								m_stats;
+};
+#endif
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <pybind11/operators.h>
 
 #include "../headers.hh"
+#include "../GilAwareOverride/GilAwareOverride.hh"
+#include "../DicosIO/DicosHeader.hh"
 
 #include "SDICOS/UserTDR.h"
  #include "SDICOS/DicosFile.h"
@@ -16,28 +18,28 @@ namespace py = pybind11;
 using namespace SDICOS;
 
 
-class PyTDR : public TDR {
+class PyTDR : public GilAwareOverride<TDR> {
 public:
-    using TDR::TDR;
-    void FreeMemory() override { PYBIND11_OVERRIDE(void,  TDR, FreeMemory); }
+    using GilAwareOverride<TDR>::GilAwareOverride;
+    void FreeMemory() override { PYDICOS_OVERRIDE(void,  TDR, FreeMemory); }
 
     bool Write(const Filename &filename, ErrorLog& errorLog, const DicosFile::TRANSFER_SYNTAX nTransferSyntax) const
-              override {PYBIND11_OVERRIDE(bool,  TDR, Write, filename, errorLog, nTransferSyntax);}  
+              override {PYDICOS_OVERRIDE(bool,  TDR, Write, filename, errorLog, nTransferSyntax);}  
 
     bool Write(MemoryBuffer &memorybuffer, ErrorLog& errorLog, const DicosFile::TRANSFER_SYNTAX nTransferSyntax) const
-              override {PYBIND11_OVERRIDE(bool,  TDR, Write, memorybuffer, errorLog, nTransferSyntax);}  
+              override {PYDICOS_OVERRIDE(bool,  TDR, Write, memorybuffer, errorLog, nTransferSyntax);}  
 
     bool Write(MemoryFile &memfile, ErrorLog& errorLog, const DicosFile::TRANSFER_SYNTAX nTransferSyntax) const
-              override {PYBIND11_OVERRIDE(bool,  TDR, Write, memfile, errorLog, nTransferSyntax);}  
+              override {PYDICOS_OVERRIDE(bool,  TDR, Write, memfile, errorLog, nTransferSyntax);}  
 
     bool Read(const Filename &filename, ErrorLog& errorLog, IMemoryManager *pMemMgr)
-              override {PYBIND11_OVERRIDE(bool,  TDR, Read, filename, errorLog, pMemMgr);}  
+              override {PYDICOS_OVERRIDE(bool,  TDR, Read, filename, errorLog, pMemMgr);}  
     
     bool Read(MemoryFile &memfile, ErrorLog& errorLog, IMemoryManager *pMemMgr)
-              override {PYBIND11_OVERRIDE(bool,  TDR, Read, memfile, errorLog, pMemMgr);}  
+              override {PYDICOS_OVERRIDE(bool,  TDR, Read, memfile, errorLog, pMemMgr);}  
 
     IODCommon::MODALITY GetModality() const
-              override {PYBIND11_OVERRIDE(IODCommon::MODALITY, TDR, GetModality);}  
+              override {PYDICOS_OVERRIDE(IODCommon::MODALITY, TDR, GetModality);}  
     
 };
 
@@ -251,7 +253,8 @@ void export_TDR(py::module &m)
                      (&PyTDR::TDR::Write, py::const_), 
                      py::arg("filename"), 
                      py::arg("errorLog"),
-                     py::arg("nTransferSyntax") = DicosFile::enumLosslessJPEG)
+                     py::arg("nTransferSyntax") = DicosFile::enumLosslessJPEG,
+                     py::call_guard<py::gil_scoped_release>())
         .def("Write", py::overload_cast<MemoryBuffer&, 
                                         ErrorLog&, 
                                         const DicosFile::TRANSFER_SYNTAX
@@ -259,7 +262,8 @@ void export_TDR(py::module &m)
                      (&PyTDR::TDR::Write, py::const_), 
                      py::arg("memorybuffer"), 
                      py::arg("errorLog"),
-                     py::arg("nTransferSyntax") = DicosFile::enumLosslessJPEG)
+                     py::arg("nTransferSyntax") = DicosFile::enumLosslessJPEG,
+                     py::call_guard<py::gil_scoped_release>())
         .def("Write", py::overload_cast<MemoryFile&, 
                                         ErrorLog&, 
                                         const DicosFile::TRANSFER_SYNTAX
@@ -267,7 +271,8 @@ void export_TDR(py::module &m)
                      (&PyTDR::TDR::Write, py::const_),
                      py::arg("memfile"), 
                      py::arg("errorlog"),
-                     py::arg("nTransferSyntax") = DicosFile::enumLosslessJPEG)
+                     py::arg("nTransferSyntax") = DicosFile::enumLosslessJPEG,
+                     py::call_guard<py::gil_scoped_release>())
         .def("Read", py::overload_cast<const Filename&, 
                                        ErrorLog&, 
                                        IMemoryManager*
@@ -275,7 +280,8 @@ void export_TDR(py::module &m)
                      (&PyTDR::TDR::Read),
                      py::arg("filename"), 
                      py::arg("errorlog"),
-                     py::arg("pMemMgr") = S_NULL)
+                     py::arg("pMemMgr") = S_NULL,
+                     py::call_guard<py::gil_scoped_release>())
         .def("Read", py::overload_cast<MemoryFile&, 
                                        ErrorLog& , 
                                        IMemoryManager*
@@ -283,7 +289,14 @@ void export_TDR(py::module &m)
                      (&PyTDR::TDR::Read),
                      py::arg("memfile"), 
                      py::arg("errorlog"),
-                     py::arg("pMemMgr") = S_NULL)   
+                     py::arg("pMemMgr") = S_NULL,
+                     py::call_guard<py::gil_scoped_release>())   
+        .def("read_metadata", &py_read_metadata<TDR>,
+                     py::arg("filename"), 
+                     py::arg("errorlog"),
+                     py::arg("pMemMgr") = S_NULL,
+                     "Read the file without decoding its pixel data. Returns (read, pixel_data_decoded): "
+                     "pixel_data_decoded is True if the file had to be read whole")
         .def("GetModality", py::overload_cast<>(&PyTDR::TDR::GetModality, py::const_))
         .def("SetInstanceNumber", &TDR::SetInstanceNumber, py::arg("nInstanceNumber"))
         .def("GetInstanceNumber", &TDR::GetInstanceNumber)
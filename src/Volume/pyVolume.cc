@@ -1,35 +1,99 @@
 #include "../headers.hh"
 #include "SDICOS/Volume.h"
+#include "../ImageDataType/ImageDataType.hh"
+
+#include <cstring>
+#include <new>
  
 using namespace SDICOS;
 
-void set_data(Volume& volume, py::array_t<uint16_t, py::array::c_style | py::array::forcecast> array_3d_np) {
+// Copies a C-contiguous (depth, height, width) buffer into slices allocated and owned by the volume
+template<typename T>
+void copy_volume_data(Volume& volume, const T* pSource, const S_UINT32 nWidth, const S_UINT32 nHeight, const S_UINT32 nDepth)
+{
+    volume.Allocate(ImageDataTraits<T>::value, nWidth, nHeight, nDepth);
+    Array3DLarge<T>* pArray = ImageDataTraits<T>::Get(volume);
+    pArray->SetMemoryPolicy(MemoryPolicy::OWNS_SLICES);
+
+    const size_t nSliceSize = size_t(nWidth) * nHeight;
+    py::gil_scoped_release release;
+    for (S_UINT32 z = 0; z < nDepth; z++) {
+        std::memcpy(pArray->GetSlice(z)->GetBuffer(), pSource + z * nSliceSize, nSliceSize * sizeof(T));
+    }
+}
+
+// Points the volume slices directly at a C-contiguous (depth, height, width) buffer.
+// The volume does not own the slices, so the buffer must outlive the volume.
+template<typename T>
+void adopt_volume_data(Volume& volume, T* pSource, const S_UINT32 nWidth, const S_UINT32 nHeight, const S_UINT32 nDepth)
+{
+    volume.Allocate(ImageDataTraits<T>::value);
+    Array3DLarge<T>* pArray = ImageDataTraits<T>::Get(volume);
+    pArray->SetMemoryPolicy(MemoryPolicy::DOES_NOT_OWN_SLICES);
+
+    const size_t nSliceSize = size_t(nWidth) * nHeight;
+    for (S_UINT32 z = 0; z < nDepth; z++) {
+        if (S_NULL == pArray->AddSlice(pSource + z * nSliceSize, nWidth, nHeight)) {
+            throw std::runtime_error("Failed to add slice " + std::to_string(z) + " to the volume.");
+        }
+    }
+}
+
+// Sets the volume data from a (depth, height, width) NumPy array of any supported data type.
+// By default the volume adopts the array memory and a capsule holding a reference on the array is returned.
+// Nothing else keeps the array alive: the volume usually belongs to a CT section, which Python does not see,
+// so the caller must hold the capsule as long as the CT uses the data. CTLoader.set_data does so.
+// With bCopy, or when the array is not C-contiguous and writeable, the data is copied into memory owned
+// by the volume and None is returned.
+py::object set_data(Volume& volume, py::array array_3d_np, const bool bCopy) {
 
     if (array_3d_np.ndim() != 3) {
         throw std::invalid_argument("Input array must have three dimensions.");
     }
-    if (!array_3d_np.dtype().is(py::dtype::of<uint16_t>())) {
-        throw std::invalid_argument("Input array must have uint16_t data type.");
-    }
 
-    uint16_t* array_3d_np_ptr = static_cast<uint16_t*>(array_3d_np.request().ptr);
+    const S_UINT32 depth = static_cast<S_UINT32>(array_3d_np.shape(0));
+    const S_UINT32 height = static_cast<S_UINT32>(array_3d_np.shape(1));
+    const S_UINT32 width = static_cast<S_UINT32>(array_3d_np.shape(2));
+    const bool bAdopt = !bCopy && 
+                        (array_3d_np.flags() & py::array::c_style) && 
+                        array_3d_np.writeable();
 
-    auto shape = array_3d_np.shape();
-    size_t depth = shape[0];
-    size_t height = shape[1];
-    size_t width = shape[2];
+    return DispatchNumpyDataType(array_3d_np, [&](auto tag) -> py::object {
+        using T = typename decltype(tag)::type;
 
-    // std::cout <<depth << height << width << std::endl;
+        if (!bAdopt) {
+            auto contiguous = py::array_t<T, py::array::c_style | py::array::forcecast>::ensure(array_3d_np);
+            copy_volume_data<T>(volume, contiguous.data(), width, height, depth);
+            return py::none();
+        }
 
-    volume.Allocate(ImageDataBase::IMAGE_DATA_TYPE::enumUnsigned16Bit, width, height, depth);
+        adopt_volume_data<T>(volume, static_cast<T*>(array_3d_np.mutable_data()), width, height, depth);
 
-    SDICOS::S_UINT32 z;
-    SDICOS::Array3DLarge<SDICOS::S_UINT16>* array3d_large = volume.GetUnsigned16();
-    for(z = 0; z < depth; z++){
-        SDICOS::S_UINT16* target_slice = array3d_large->GetSlice(z)->GetBuffer();
-        uint16_t* source_slice = array_3d_np_ptr + z * width * height;
-        memcpy(target_slice, source_slice, width * height * sizeof(SDICOS::S_UINT16));
-    }
+        return py::capsule(new py::object(array_3d_np), [](void* p) { delete static_cast<py::object*>(p); });
+    });
+}
+
+// Allocates the volume slices back to back in a single slab aligned on a cache line, so the whole
+// volume is one (depth, height, width) block that can be handed to vectorized code as one pointer.
+// The slab is zeroed and returned as a writeable NumPy array, which owns it: the volume only points into it,
+// so the caller must hold the array as long as the CT uses the volume. CTLoader.allocate_contiguous does so.
+py::array allocate_contiguous(Volume& volume, const ImageDataBase::IMAGE_DATA_TYPE nDataType,
+                              const S_UINT32 nWidth, const S_UINT32 nHeight, const S_UINT32 nDepth) {
+
+    static constexpr size_t SLAB_ALIGNMENT = 64;
+
+    return DispatchImageDataType(nDataType, [&](auto tag) -> py::array {
+        using T = typename decltype(tag)::type;
+
+        const size_t nCount = size_t(nWidth) * nHeight * nDepth;
+        const size_t nSizeInBytes = (nCount > 0 ? nCount : 1) * sizeof(T);
+        void* pSlab = ::operator new[](nSizeInBytes, std::align_val_t(SLAB_ALIGNMENT));
+        py::capsule slab(pSlab, [](void* p) { ::operator delete[](p, std::align_val_t(SLAB_ALIGNMENT)); });
+        std::memset(pSlab, 0, nSizeInBytes);
+
+        adopt_volume_data<T>(volume, static_cast<T*>(pSlab), nWidth, nHeight, nDepth);
+        return py::array_t<T>({ py::ssize_t(nDepth), py::ssize_t(nHeight), py::ssize_t(nWidth) }, static_cast<T*>(pSlab), slab);
+    });
 }
 
 
@@ -101,6 +165,7 @@ void export_Volume(py::module &m)
         .def("Allocate", py::overload_cast<const ImageDataBase::IMAGE_DATA_TYPE>(&Volume::Allocate),  py::arg("nDataType"))
         .def("Allocate", py::overload_cast<const ImageDataBase::IMAGE_DATA_TYPE, S_UINT32, const S_UINT32, const S_UINT32>(&Volume::Allocate),  
                                            py::arg("nDataType"),  py::arg("nWidth"),  py::arg("nHeight"),  py::arg("nDepth"))
+        .def("FreeMemory", &Volume::FreeMemory)
         .def("GetSigned8", (Array3DLarge<S_INT8>* (Volume::*)()) &Volume::GetSigned8, py::return_value_policy::reference_internal)
         .def("GetSigned16", (Array3DLarge<S_INT16>* (Volume::*)()) &Volume::GetSigned16, py::return_value_policy::reference_internal)
         .def("GetSigned32", (Array3DLarge<S_INT32>* (Volume::*)()) &Volume::GetSigned32, py::return_value_policy::reference_internal)     
@@ -128,6 +193,13 @@ void export_Volume(py::module &m)
         .def("GetCapacity", &Volume::GetCapacity)
         .def("Begin", &Volume::Begin)
         .def("End", &Volume::End)
-        .def_static("set_data", &set_data, "Set volume data from NumPy array", py::arg("volume"), py::arg("data"));
+        .def_static("set_data", &set_data, 
+                    "Set volume data from NumPy array, adopting its memory unless copy is set. "
+                    "Returns the capsule keeping the adopted array alive, which must be held as long as the volume uses it, or None", 
+                    py::arg("volume"), py::arg("data"), py::arg("copy") = false)
+        .def_static("allocate_contiguous", &allocate_contiguous, 
+                    "Allocate the volume slices in one aligned slab and return it as a NumPy array, "
+                    "which owns the slab and must be held as long as the volume uses it", 
+                    py::arg("volume"), py::arg("nDataType"), py::arg("nWidth"), py::arg("nHeight"), py::arg("nDepth"));
 
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -21,6 +21,7 @@ void export_SECTION(py::module &m);
 void export_CT(py::module &m);
 void export_DCSSTRING(py::module &m);
 void export_MEMORYBUFFER(py::module &m);
+void export_MEMORYFILE(py::module &m);
 void export_ARRAY1D_PAIR_BOOL_MEMBUFF(py::module &m);
 void export_Volume(py::module &m);
 void export_DicosFileListing(py::module &m);
@@ -35,6 +36,8 @@ void export_DCSCLIENT(py::module &m);
 void export_IDCSSERVER(py::module &m);
 void export_DCSSERVER(py::module &m);
 void export_IRECEIVECALLBACK(py::module &m);
+void export_INFLIGHTBUDGET(py::module &m);
+void export_QUEUEDRECEIVECALLBACK(py::module &m);
 void export_DataProcessingMultipleConnections(py::module &m);
 void export_ICLIENTAUTHENTICATIONCALLBACK(py::module &m);
 void export_AuthenticationCallbackConnectionsSpecificClientApplications(py::module &m);
@@ -42,5 +45,7 @@ void export_DataProcessingConnectionsSpecificClientApplications(py::module &m);
 void export_AuthenticationCallbackConnectionsFromClientsValidUserName(py::module &m);
 void export_AuthenticationCallbackClientsPresentValidUserNamePasscode(py::module &m);
 void export_AuthenticationCallbackAllowConnectsFromSpecificClientsPresentValidUserNamePasscode(py::module &m);
+void export_InFlightBudgetAuthenticationCallback(py::module &m);
+void export_DICOSIO(py::module &m);
 
 #endif
\ No newline at end of file
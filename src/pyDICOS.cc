@@ -17,6 +17,7 @@ PYBIND11_MODULE(pyDICOS, m)
    export_CT(m);
    export_DCSSTRING(m);
    export_MEMORYBUFFER(m);
+   export_MEMORYFILE(m);
    export_Array1D<S_UINT16>(m, "S_UINT16");
    export_Array1D<S_INT16>(m, "S_INT16");
    export_Array1D<S_UINT8>(m, "S_UINT8");
@@ -70,6 +71,7 @@ PYBIND11_MODULE(pyDICOS, m)
    export_BITMAP(m);
    export_DCSGUID(m);
    export_SopClassUID(m);
+   export_DICOSIO(m);
 
    export_GeneralSeriesModule(m);
 
@@ -77,6 +79,8 @@ PYBIND11_MODULE(pyDICOS, m)
    export_IDCSSERVER(m);
    export_DCSSERVER(m);
    export_IRECEIVECALLBACK(m);
+   export_INFLIGHTBUDGET(m);
+   export_QUEUEDRECEIVECALLBACK(m);
    export_DataProcessingMultipleConnections(m);
    export_ICLIENTAUTHENTICATIONCALLBACK(m);
    export_AuthenticationCallbackConnectionsSpecificClientApplications(m);
@@ -84,4 +88,5 @@ PYBIND11_MODULE(pyDICOS, m)
    export_AuthenticationCallbackConnectionsFromClientsValidUserName(m);
    export_AuthenticationCallbackClientsPresentValidUserNamePasscode(m);
    export_AuthenticationCallbackAllowConnectsFromSpecificClientsPresentValidUserNamePasscode(m);
+   export_InFlightBudgetAuthenticationCallback(m);
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+import os
+import threading
+
+from pyDICOS import (
+    DcsApplicationEntity,
+    DcsServer,
+    IDcsServer,
+    IngestReceiveCallback,
+)
+
+
+def main():
+    # The server threads only queue the received CT, DX and TDR.
+    # Four native workers write them to disk, then hand them over to Python.
+    # Files are named after the SOP Instance UID and existing files are never overwritten.
+    output_folder = os.path.abspath("ReceivedData")
+    os.makedirs(output_folder, exist_ok=True)
+    icallback = IngestReceiveCallback(
+        nNumWorkers=4, strOutputFolder=output_folder, bHandToPython=True
+    )
+    server = DcsServer()
+    server.SetPort(1000)
+    server.SetApplicationName(DcsApplicationEntity("ServerExample"))
+
+    if (
+        server.StartListening(
+            icallback, None, IDcsServer.RETRIEVE_METHOD.enumMethodUserAPI, False
+        )
+        == True
+    ):
+        print(
+            "Failed to start DICOS server. IP:Port: ",
+            server.GetIP(),
+            ":",
+            server.GetPort(),
+        )
+        return 1
+
+    def consume():
+        # Stops once the callback is closed and the workers are done
+        for received in icallback:
+            print(received["modality"], "from", received["client_ip"], "written to", received["filename"])
+
+    consumer = threading.Thread(target=consume)
+    consumer.start()
+
+    input("Press enter to stop server")
+    server.StopListening()
+    icallback.Close()
+    consumer.join()
+    # queued, in_progress and output_queued are the depths of the three stages
+    print(icallback.get_stats())
+    for error in icallback.get_write_errors():
+        print("Failed to write", error["filename"], error["errorlog"].GetErrorLog())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,48 @@
+import threading
+
+from pyDICOS import (
+    DcsApplicationEntity,
+    DcsServer,
+    IDcsServer,
+    QueuedReceiveCallback,
+)
+
+
+def main():
+    # The server threads push the received CT, DX and TDR onto a native queue and return at once
+    icallback = QueuedReceiveCallback(nCapacity=32)
+    server = DcsServer()
+    server.SetPort(1000)
+    server.SetApplicationName(DcsApplicationEntity("ServerExample"))
+
+    if (
+        server.StartListening(
+            icallback, None, IDcsServer.RETRIEVE_METHOD.enumMethodUserAPI, False
+        )
+        == True
+    ):
+        print(
+            "Failed to start DICOS server. IP:Port: ",
+            server.GetIP(),
+            ":",
+            server.GetPort(),
+        )
+        return 1
+
+    def consume():
+        # Iterating blocks with the GIL released and stops once the callback is closed
+        for received in icallback:
+            print(received["modality"], "from", received["client_ip"])
+
+    consumer = threading.Thread(target=consume)
+    consumer.start()
+
+    input("Press enter to stop server")
+    server.StopListening()
+    icallback.Close()
+    consumer.join()
+    print(icallback.get_stats())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,68 @@
+import threading
+
+from pyDICOS import (
+    AuthenticationCallbackConnectsSpecificClientApps,
+    DcsApplicationEntity,
+    DcsServer,
+    IDcsServer,
+    InFlightBudgetAuthenticationCallback,
+    IngestReceiveCallback,
+)
+
+
+def main():
+    # At most 2 GiB or 16 objects are held between the server and the consumer.
+    # Over budget, server threads wait up to 2 seconds for room, which slows the clients down,
+    # then drop the object: get_stats() counts it in "dropped" and "rejected".
+    icallback = IngestReceiveCallback(nNumWorkers=4)
+    icallback.SetInFlightBudget(
+        nMaxBytes=2 * 1024 * 1024 * 1024, nMaxObjects=16, nMaxDelayMilliseconds=2000
+    )
+
+    # Client application names are still checked by the wrapped callback.
+    # Accepted associations are held up to 5 seconds, then rejected, while over budget
+    applicationcallback = AuthenticationCallbackConnectsSpecificClientApps()
+    authenticationcallback = InFlightBudgetAuthenticationCallback(
+        icallback, pAuthenticationCallback=applicationcallback, nDelayMilliseconds=5000
+    )
+
+    server = DcsServer()
+    server.SetPort(1000)
+    server.SetApplicationName(DcsApplicationEntity("ServerExample"))
+    server.RequireApplicationNames()
+
+    if (
+        server.StartListening(
+            icallback,
+            authenticationcallback,
+            IDcsServer.RETRIEVE_METHOD.enumMethodUserAPI,
+            False,
+        )
+        == True
+    ):
+        print(
+            "Failed to start DICOS server. IP:Port: ",
+            server.GetIP(),
+            ":",
+            server.GetPort(),
+        )
+        return 1
+
+    def consume():
+        for received in icallback:
+            print(received["modality"], "from", received["client_ip"])
+            # in_flight_bytes is the gauge of the memory held by the pipeline
+            print("In flight:", icallback.GetBytesInFlight(), "bytes")
+
+    consumer = threading.Thread(target=consume)
+    consumer.start()
+
+    input("Press enter to stop server")
+    server.StopListening()
+    icallback.Close()
+    consumer.join()
+    print(icallback.get_stats())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,43 @@
+from pyDICOS import (
+    DataProcessingMultipleConnections,
+    DcsApplicationEntity,
+    DcsServer,
+    IDcsServer,
+    PooledReceiveAllocators,
+)
+
+
+def main():
+    icallback = DataProcessingMultipleConnections()
+    # One slab pool shared by the connections, buffers are reused once received data is released
+    allocators = PooledReceiveAllocators(nNumAllocators=4)
+    server = DcsServer()
+    server.SetPort(1000)
+    server.SetApplicationName(DcsApplicationEntity("ServerExample"))
+    server.SetCustomAllocators(allocators)
+
+    if (
+        server.StartListening(
+            icallback, None, IDcsServer.RETRIEVE_METHOD.enumMethodUserAPI, False
+        )
+        == True
+    ):
+        print(
+            "Failed to start DICOS server. IP:Port: ",
+            server.GetIP(),
+            ":",
+            server.GetPort(),
+        )
+        return 1
+
+    input("Press enter to stop server")
+    server.StopListening()
+
+    # Once warmed up, misses stay at zero: every receive buffer came from the pool
+    stats = allocators.GetPool().get_stats()
+    print("Pool hits:", stats["hits"], "heap fallbacks:", stats["misses"])
+    print("High-water bytes:", stats["high_water_bytes"])
+
+
+if __name__ == "__main__":
+    main()
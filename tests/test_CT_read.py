@@ -1,7 +1,12 @@
+import gc
+import shutil
+import warnings
 import numpy as np
+from concurrent.futures import ThreadPoolExecutor
 import pytest
 from pathlib import Path
-from pydicos import dcsread, dcswrite, CTLoader
+from pydicos import dcsread, dcsread_many, dcswrite, CTLoader, DXLoader, TDRLoader, LazyVolume, CTSliceReader
+from pyDICOS import CT, ArrayMemoryManager, ErrorLog, Filename, MemoryFile, PooledMemoryManager, PooledReceiveAllocators, SlabPoolMemoryManager, SlabSizeClass, probe_modality, probe_pixel_data, read_many
 from tests.test_utils import get_tdr_data_output_template, get_pto_data, set_alarm_decision
 
 
@@ -36,6 +41,311 @@ def test_loading_from_file_in_place():
     assert np.all(data3[0] == 48879)
 
 
+@pytest.mark.order(after="tests/test_CT_read.py::test_loading_from_file_in_place")
+def test_lazy_loading(tmp_path):
+    # SimpleCT0000.dcs is uncompressed, read lazily from a copy that is changed on disk
+    path = tmp_path / "SimpleCT0000.dcs"
+    shutil.copyfile(Path("SimpleCT", "SimpleCT0000.dcs"), path)
+    ct_object = CTLoader(path, lazy=True)
+    assert not ct_object.pixel_data_decoded
+    volume = ct_object.get_data()[0]
+    assert isinstance(volume, LazyVolume) and volume.is_direct
+    assert volume.shape == (40, 20, 10) and volume.dtype == np.uint16
+    assert np.all(volume[3:5] == 48879)
+
+    # Slices already read are kept, the others are read from the file when indexed
+    pixel_data = probe_pixel_data(str(path))
+    with open(path, "r+b") as file:
+        for z in (3, 10):
+            file.seek(pixel_data["offset"] + z * 20 * 10 * 2)
+            file.write(np.full((20, 10), 7, dtype=np.uint16).tobytes())
+    assert np.all(volume[3] == 48879)
+    assert np.all(volume[10] == 7)
+    assert volume[-1, 2:4].shape == (2, 10)
+
+    # Copies never share the cache that later loads write into
+    copied = ct_object.get_data(copy=True)[0]
+    assert not np.shares_memory(copied, volume[:])
+    with pytest.raises(ValueError):
+        volume.__array__(np.float32, copy=False)
+
+    # The slices are loaded into the section to be written
+    ct_object.write(tmp_path / "written.dcs")
+    assert np.array_equal(CTLoader(tmp_path / "written.dcs").get_data()[0], copied)
+
+    # SimpleCT0000_2.dcs is lossless JPEG, decoded once right away
+    ct_object = CTLoader(Path("SimpleCT", "SimpleCT0000_2.dcs"), lazy=True)
+    assert ct_object.pixel_data_decoded
+    data = ct_object.get_data()[0]
+    assert isinstance(data, np.ndarray) and data.shape == (40, 20, 10)
+    assert np.all(data == 48879)
+
+
+@pytest.mark.order(after="tests/test_CT_read.py::test_loading_from_file_in_place")
+def test_mmap_loading(tmp_path):
+    ct_object = CTLoader(Path("SimpleCT", "SimpleCT0000.dcs"), mmap=True)
+    data = ct_object.get_data()
+    assert data[0].shape == (40, 20, 10) and not data[0].flags.writeable
+    assert np.all(data[0] == 48879)
+    assert ct_object.get_data(copy=True)[0].flags.writeable
+
+    # The mapped slices are copied into the section to be written
+    ct_object.write(tmp_path / "written.dcs")
+    assert np.all(CTLoader(tmp_path / "written.dcs").get_data()[0] == 48879)
+
+    ct_object = CTLoader(Path("SimpleCT", "SimpleCT0000_2.dcs"), mmap=True)
+    assert np.all(ct_object.get_data()[0] == 48879)
+
+
+@pytest.mark.order(after="tests/test_CT_read.py::test_loading_from_file_in_place")
+def test_slice_reader():
+    for path in [Path("SimpleCT", "SimpleCT0000.dcs"), Path("SimpleCT", "SimpleCT0000_2.dcs")]:
+        slices = [(section, z, data.copy()) for section, z, data in CTSliceReader(path, ring_size=2)]
+        assert [z for _, z, _ in slices] == list(range(40))
+        assert all(section == 0 for section, _, _ in slices)
+        assert all(data.shape == (20, 10) and np.all(data == 48879) for _, _, data in slices)
+
+    # Stopping early joins the reader thread
+    for _, z, _ in CTSliceReader(Path("SimpleCT", "SimpleCT0000.dcs"), ring_size=1):
+        if z == 3:
+            break
+
+
+@pytest.mark.order(after="tests/test_CT_write.py::test_create_ct_files")
+def test_memory_file_roundtrip():
+    ct_object = CTLoader(Path("SimpleCT", "SimpleCT0000.dcs"))
+    memfile = MemoryFile()
+    assert ct_object.Write(memfile, ErrorLog(), CT.TRANSFER_SYNTAX.enumLittleEndianExplicit)
+    size = len(memfile)
+    payload = memfile.move_to_memoryview()
+    assert isinstance(payload, memoryview) and len(payload) == size > 0 and len(memfile) == 0
+
+    # The view owns the output, so writing again does not free it
+    assert ct_object.Write(memfile, ErrorLog(), CT.TRANSFER_SYNTAX.enumLittleEndianExplicit)
+    ct_copy = CTLoader()
+    assert ct_copy.Read(MemoryFile.from_buffer(payload), ErrorLog(), None)
+    assert np.all(ct_copy.get_data()[0] == 48879)
+
+    # Moving content read from a Python buffer keeps that buffer alive
+    reread = MemoryFile.from_buffer(bytes(payload)).move_to_memoryview()
+    assert reread.readonly and reread == payload
+
+
+def test_get_data_dtypes():
+    data = [np.arange(4 * 5 * 6, dtype=np.int16).reshape(4, 5, 6), np.random.rand(3, 4, 5).astype(np.float32)]
+    ct_object = CTLoader()
+    ct_object.set_data(data)
+
+    views = ct_object.get_data()
+    assert [v.dtype for v in views] == [np.int16, np.float32]
+    for view, array in zip(views, data):
+        assert np.array_equal(view, array)
+        assert np.shares_memory(view, array)
+
+    copies = ct_object.get_data(copy=True)
+    for copied, array in zip(copies, data):
+        assert np.array_equal(copied, array)
+        assert not np.shares_memory(copied, array)
+
+
+@pytest.mark.order(after="tests/test_CT_write.py::test_create_ct_files")
+def test_loading_from_threads():
+    # Read releases the GIL, so several files can be decoded at the same time
+    paths = [Path("SimpleCT", "SimpleCT0000.dcs")] * 8
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        loaded = list(pool.map(CTLoader, paths))
+    for ct_object in loaded:
+        data = ct_object.get_data()
+        assert data[0].shape == (40, 20, 10)
+        assert np.all(data[0] == 48879)
+
+
+@pytest.mark.order(after="tests/test_CT_write.py::test_create_ct_files")
+def test_pooled_memory_manager():
+    # A single pool serves the slices of concurrent reads
+    manager = PooledMemoryManager(nBufferSizeInBytes=20 * 10 * 2, nNumBuffers=8 * 40)
+
+    def read(_):
+        ct = CTLoader()
+        assert ct.Read(Filename(str(Path("SimpleCT", "SimpleCT0000.dcs"))), ErrorLog(), manager)
+        return ct
+
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        loaded = list(pool.map(read, range(8)))
+    assert manager.GetNumberOfFreeBuffers() == 0
+    for ct in loaded:
+        assert np.all(ct.get_data()[0] == 48879)
+    del loaded, ct
+    assert manager.GetNumberOfFreeBuffers() == manager.GetNumberOfBuffers()
+
+
+@pytest.mark.order(after="tests/test_CT_write.py::test_create_ct_files")
+def test_slab_pool_memory_manager():
+    # The 20x10 uint16 slices land in the 512 bytes class, which grows by 40 buffers at a time
+    manager = SlabPoolMemoryManager([SlabSizeClass(1024), SlabSizeClass(256), SlabSizeClass(512, nMaxBuffers=160, nGrowBy=40)])
+    assert [c.m_nBufferSizeInBytes for c in manager.GetSizeClasses()] == [256, 512, 1024]
+
+    for _ in range(3):
+        ct_object = CTLoader()
+        assert ct_object.Read(Filename(str(Path("SimpleCT", "SimpleCT0000.dcs"))), ErrorLog(), manager)
+        assert np.all(ct_object.get_data()[0] == 48879)
+        assert manager.GetNumberOfBuffers(1) == 40
+        assert manager.GetNumberOfFreeBuffers(1) == 0
+        del ct_object
+    assert manager.GetNumberOfBuffers(0) == manager.GetNumberOfBuffers(2) == 0
+    assert manager.GetNumberOfFreeBuffers(1) == 40
+
+    assert manager.Shrink() == 40 * 512
+    assert manager.GetNumberOfBuffers(1) == 0
+
+
+@pytest.mark.order(after="tests/test_CT_write.py::test_create_ct_files")
+def test_slab_pool_huge_pages():
+    # Huge pages and NUMA binding are best effort, reads work whichever pages back the slabs.
+    # A slab of 40 buffers is smaller than a huge page and uses regular pages, one of 4096 buffers may not.
+    for grow_by in [40, 4096]:
+        manager = SlabPoolMemoryManager([SlabSizeClass(512, nGrowBy=grow_by)], bHugePages=True, bNumaLocal=True)
+        ct_object = CTLoader()
+        assert ct_object.Read(Filename(str(Path("SimpleCT", "SimpleCT0000.dcs"))), ErrorLog(), manager)
+        assert np.all(ct_object.get_data()[0] == 48879)
+
+        stats = manager.get_slab_stats()
+        assert stats["huge_pages"] and stats["numa_local"]
+        assert stats["slab_bytes"] >= grow_by * 512
+        if grow_by * 512 < stats["huge_page_size"]:
+            assert stats["slab_bytes"] < stats["huge_page_size"]
+            assert stats["hugetlb_bytes"] == stats["madvised_bytes"] == 0
+        assert stats["hugetlb_bytes"] + stats["madvised_bytes"] <= stats["slab_bytes"]
+        assert stats["transparent_huge_page_bytes"] <= stats["madvised_bytes"]
+        del ct_object
+        manager.Shrink()
+        assert manager.get_slab_stats()["slab_bytes"] == 0
+
+
+@pytest.mark.order(after="tests/test_CT_write.py::test_create_ct_files")
+def test_memory_manager_stats():
+    # 30 buffers for 40 slices of 400 bytes, the last 10 slices are left to the library
+    manager = PooledMemoryManager(nBufferSizeInBytes=400, nNumBuffers=30)
+    ct_object = CTLoader()
+    assert ct_object.Read(Filename(str(Path("SimpleCT", "SimpleCT0000.dcs"))), ErrorLog(), manager)
+    stats = manager.get_stats()
+    assert stats["hits"] == 30 and stats["misses"] == 10
+    assert stats["bytes_outstanding"] == stats["high_water_bytes"] == 30 * 400
+    assert stats["histogram"] == {256: 40}
+
+    del ct_object
+    stats = manager.get_stats()
+    assert stats["deallocations"] == 30
+    assert stats["bytes_outstanding"] == 0 and stats["high_water_bytes"] == 30 * 400
+
+    manager.reset_stats()
+    stats = manager.get_stats()
+    assert stats["hits"] == stats["misses"] == stats["high_water_bytes"] == 0
+    assert stats["histogram"] == {}
+
+
+@pytest.mark.order(after="tests/test_CT_write.py::test_create_ct_files")
+def test_pooled_receive_allocators():
+    # The 400 bytes slices land in the 4 KiB class, which grows by 16 buffers at a time
+    allocators = PooledReceiveAllocators(nNumAllocators=2)
+    assert allocators.GetNumberOfAllocators() == 2
+    pool = allocators.GetPool()
+    for _ in range(3):
+        ct_object = CTLoader()
+        assert ct_object.Read(Filename(str(Path("SimpleCT", "SimpleCT0000.dcs"))), ErrorLog(), pool)
+        assert pool.get_stats()["bytes_outstanding"] == 40 * 400
+        assert pool.GetNumberOfBuffers(0) == 48
+        del ct_object
+
+    # Once warmed up the pool serves every read without growing
+    stats = pool.get_stats()
+    assert stats["hits"] == stats["deallocations"] == 3 * 40
+    assert stats["misses"] == 0 and stats["bytes_outstanding"] == 0
+    assert pool.GetNumberOfFreeBuffers(0) == 48
+
+    # Received objects keep the pool alive after the allocators are gone
+    ct_object = CTLoader()
+    assert ct_object.Read(Filename(str(Path("SimpleCT", "SimpleCT0000.dcs"))), ErrorLog(), pool)
+    del pool, allocators
+    gc.collect()
+    assert np.all(ct_object.get_data()[0] == 48879)
+    del ct_object
+
+
+@pytest.mark.order(after="tests/test_CT_write.py::test_create_ct_files")
+def test_array_memory_manager():
+    # The slices are decoded straight into the staging array
+    staging = np.zeros((40, 20, 10), dtype=np.uint16)
+    manager = ArrayMemoryManager(staging)
+    for _ in range(2):
+        ct_object = CTLoader()
+        assert ct_object.Read(Filename(str(Path("SimpleCT", "SimpleCT0000.dcs"))), ErrorLog(), manager)
+        assert np.all(staging == 48879)
+        assert manager.GetBytesUsed() == staging.nbytes
+        assert not manager.Rewind()
+        del ct_object
+        assert manager.Rewind()
+        staging[:] = 0
+    assert manager.get_stats()["misses"] == 0
+
+    with pytest.raises(RuntimeError):
+        ArrayMemoryManager(staging[:, :, ::2])
+
+
+@pytest.mark.order(after=["tests/test_CT_write.py::test_create_ct_files", "tests/test_DX_write.py::test_create_dx_processing"])
+def test_dcsread_many():
+    paths = [Path("SimpleCT", "SimpleCT0000.dcs"), Path("DXFiles", "SimpleProcessingDX.dcs"), "missing.dcs"] * 3
+    results = dcsread_many(paths, max_workers=4)
+    assert len(results) == len(paths)
+    for n in range(0, len(paths), 3):
+        (ct_object, ct_err), (dx_object, dx_err), (missing, missing_err) = results[n:n + 3]
+        assert isinstance(ct_object, CTLoader) and ct_err.NumErrors() == 0
+        assert np.all(ct_object.get_data()[0] == 48879)
+        assert isinstance(dx_object, DXLoader) and dx_err.NumErrors() == 0
+        assert missing is None and missing_err.NumErrors() > 0
+
+    arrays = dcsread_many(paths[:1] * 4, return_data=True)
+    for data, _ in arrays:
+        assert data[0].shape == (40, 20, 10)
+
+    # One object cannot be the target of two concurrent reads
+    ct = CT()
+    with pytest.raises(ValueError):
+        read_many([(ct, str(paths[0]), ErrorLog()), (ct, str(paths[0]), ErrorLog())])
+
+
+@pytest.mark.order(after="tests/test_TDR_write.py::test_ct_linked_tdr")
+def test_probe_modality():
+    assert probe_modality(str(Path("CTwithTDR", "CT.dcs"))) == "CT"
+    assert probe_modality(str(Path("CTwithTDR", "TDR.dcs"))) == "TDR"
+    assert probe_modality("missing.dcs") == ""
+    assert isinstance(dcsread(Path("CTwithTDR", "TDR.dcs")), TDRLoader)
+
+
+@pytest.mark.order(after="tests/test_TDR_write.py::test_ct_linked_tdr")
+def test_metadata_only(tmp_path):
+    full = CTLoader(Path("CTwithTDR", "CT.dcs"))
+    with warnings.catch_warnings():
+        # A metadata read that had to decode the pixel data warns
+        warnings.simplefilter("error")
+        header = CTLoader(Path("CTwithTDR", "CT.dcs"), metadata_only=True)
+        tdr = TDRLoader(Path("CTwithTDR", "TDR.dcs"), metadata_only=True)
+    assert header.GetScanInstanceUID().Get() == full.GetScanInstanceUID().Get()
+    assert header.GetSopInstanceUID().Get() == full.GetSopInstanceUID().Get()
+    assert header.GetNumberOfSections() == full.GetNumberOfSections()
+    assert tdr.GetScanInstanceUID().Get() == full.GetScanInstanceUID().Get()
+
+    assert full.pixel_data_decoded and not header.pixel_data_decoded and not tdr.pixel_data_decoded
+    for index in range(full.GetNumberOfSections()):
+        assert full.GetSectionByIndex(index).GetPixelData().GetSizeInBytes() > 0
+        assert header.GetSectionByIndex(index).GetPixelData().GetSizeInBytes() == 0
+
+    # Writing would produce a file without pixels
+    with pytest.raises(RuntimeError):
+        dcswrite(header, tmp_path / "header.dcs")
+    assert not (tmp_path / "header.dcs").exists()
+
+
 @pytest.mark.order(after="tests/test_TDR_write.py::test_ct_linked_tdr")
 def test_generate_tdr():
     ct_object = dcsread("CTwithTDR/CT.dcs")
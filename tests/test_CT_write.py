@@ -1,4 +1,8 @@
+import gc
 import numpy as np
+import pytest
+from pathlib import Path
+from pydicos import CTLoader, CTStreamWriter
 from pyDICOS import (
     CT,
     Array3DLargeS_UINT16,
@@ -297,5 +301,95 @@ def test_create_ct_files(session_cleanup):
     ), "Simple CT Example original CT and read SimpleCT0001 are not equal"
 
 
+def test_set_volume_data():
+    ct = CT()
+    ct.SetNumberOfSections(2)
+
+    # By default the volume adopts the memory of the array
+    data = np.arange(4 * 5 * 6, dtype=np.int16).reshape(4, 5, 6)
+    volume = ct.GetSectionByIndex(0).GetPixelData()
+    keep_alive = volume.set_data(volume, data)
+    assert keep_alive is not None
+    assert ct.GetSectionByIndex(0).GetPixelDataType() == Volume.IMAGE_DATA_TYPE.enumSigned16Bit
+    assert (volume.GetWidth(), volume.GetHeight(), volume.GetDepth()) == (6, 5, 4)
+    data[1, 2, 3] = -7
+    assert np.array(volume.GetSigned16()[1], copy=False)[2, 3] == -7
+
+    # With copy=True the volume owns a copy of the data
+    data_float = np.random.rand(3, 4, 5).astype(np.float32)
+    volume = ct.GetSectionByIndex(1).GetPixelData()
+    assert volume.set_data(volume, data_float, copy=True) is None
+    data_float[0, 0, 0] = -1
+    assert np.array(volume.GetFloat()[0], copy=False)[0, 0] != -1
+
+
+def test_loader_keeps_adopted_data_alive():
+    # Only the loader holds the adopted arrays once the caller drops them
+    ct = CTLoader()
+    ct.set_data([np.arange(4 * 5 * 6, dtype=np.uint16).reshape(4, 5, 6)])
+    gc.collect()
+    np.full((4, 5, 6), 0xFFFF, dtype=np.uint16)
+    assert np.array_equal(ct.get_data(copy=True)[0], np.arange(4 * 5 * 6).reshape(4, 5, 6))
+
+
+def test_contiguous_volume():
+    ct = CT()
+    ct.SetNumberOfSections(1)
+    volume = ct.GetSectionByIndex(0).GetPixelData()
+    slab = volume.allocate_contiguous(volume, Volume.IMAGE_DATA_TYPE.enumUnsigned16Bit, 10, 20, 30)
+    assert slab.shape == (30, 20, 10) and slab.flags.writeable
+    assert slab.ctypes.data % 64 == 0
+    assert np.all(slab == 0)
+
+    array = volume.GetUnSigned16()
+    assert array.IsContiguous()
+    view = np.array(array, copy=False)
+    assert np.shares_memory(view, slab)
+    slab[2, 3, 4] = 7
+    assert np.array(array.slices()[2], copy=False)[3, 4] == 7
+    assert np.shares_memory(ct.get_sections_data(copy=False)[0], slab)
+
+    # A loader keeps the slab alive on its own
+    ct_loader = CTLoader()
+    ct_loader.SetNumberOfSections(1)
+    ct_loader.allocate_contiguous(0, Volume.IMAGE_DATA_TYPE.enumUnsigned16Bit, 10, 20, 30)[2, 3, 4] = 7
+    gc.collect()
+    np.full((30, 20, 10), 0xFFFF, dtype=np.uint16)
+    data = ct_loader.get_data(copy=True)[0]
+    assert data[2, 3, 4] == 7 and np.count_nonzero(data) == 1
+
+    # Slices allocated one by one each get their own heap block, so they are never back to back
+    # and are exposed through a read-only gathered copy
+    fragmented = Array3DLargeS_UINT16()
+    fragmented.SetMemoryPolicy(CT.VOLUME_MEMORY_POLICY.OWNS_SLICES)
+    for _ in range(3):
+        fragmented.AddSlice(10, 20)
+    fragmented.Zero(1)
+    assert not fragmented.IsContiguous()
+    gathered = np.array(fragmented, copy=False)
+    assert gathered.shape == (3, 20, 10)
+    assert not gathered.flags.writeable
+    assert np.all(gathered == 1)
+
+
+@pytest.mark.order(after="tests/test_CT_write.py::test_create_ct_files")
+def test_stream_writer():
+    ct_object = CTLoader(Path("SimpleCT", "SimpleCT0000.dcs"), metadata_only=True)
+    with CTStreamWriter(ct_object, Path("SimpleCT", "Streamed.dcs")) as writer:
+        for z in range(12):
+            writer.append(np.full((20, 10), z, dtype=np.uint16))
+    assert not list(Path("SimpleCT").glob("*.slices"))
+
+    data = CTLoader(Path("SimpleCT", "Streamed.dcs")).get_data()
+    assert data[0].shape == (12, 20, 10)
+    assert np.array_equal(data[0][:, 0, 0], np.arange(12))
+
+    with pytest.raises(ValueError):
+        with CTStreamWriter(ct_object, Path("SimpleCT", "Aborted.dcs")) as writer:
+            writer.append(np.zeros((20, 10), dtype=np.uint16))
+            writer.append(np.zeros((10, 20), dtype=np.uint16))
+    assert not Path("SimpleCT", "Aborted.dcs").exists()
+
+
 if __name__ == "__main__":
     test_create_ct_files([])
@@ -29,6 +29,37 @@ def test_loading_from_file_processing():
     assert np.all(data == suite)
 
 
+
+@pytest.mark.order(after="tests/test_DX_read.py::test_loading_from_file_processing")
+def test_mmap_loading(tmp_path):
+    suite = np.array([i for i in range(128 * 256)]).reshape(128, 256)
+    decoded = pydicos.DXLoader(Path("DXFiles", "SimpleProcessingDX.dcs"))
+
+    # The uncompressed file is mapped, the lossless JPEG one is decoded as usual
+    for name in ["SimpleProcessingDX.dcs", "SimpleProcessingDX2.dcs"]:
+        dx_object = pydicos.DXLoader(Path("DXFiles", name), mmap=True)
+        data = dx_object.get_data()
+        assert data.shape == (128, 256)
+        assert np.all(data == suite)
+        assert np.allclose(dx_object.get_data(rescale=True), decoded.get_data(rescale=True))
+
+        # Both paths rescale in place and reject the same unusable output arrays
+        out = np.empty((128, 256), dtype=np.float32)
+        assert dx_object.get_data(rescale=True, out=out) is out
+        for bad in [np.empty((128, 256)), np.empty((256, 128), dtype=np.float32),
+                    np.empty((256, 256), dtype=np.float32)[::2]]:
+            with pytest.raises(ValueError):
+                dx_object.get_data(rescale=True, out=bad)
+
+    # The mapped image is copied into the object to be written
+    dx_object = pydicos.DXLoader(Path("DXFiles", "SimpleProcessingDX.dcs"), mmap=True)
+    dx_object.write(tmp_path / "written.dcs")
+    assert np.all(pydicos.DXLoader(tmp_path / "written.dcs").get_data() == suite)
+
+    mapped = pydicos.map_pixel_data(Path("DXFiles", "SimpleProcessingDX.dcs"))
+    assert mapped.shape == (1, 128, 256) and not mapped.flags.writeable
+    assert pydicos.map_pixel_data(Path("DXFiles", "SimpleProcessingDX2.dcs")) is None
+
 @pytest.mark.order(after="tests/test_DX_write.py::test_create_dx_presentation")
 def test_loading_from_file_presentation():
     # Test 4: Load DX from a file written with pyDICOS
@@ -49,6 +80,35 @@ def test_loading_from_file_palette():
     assert np.all(data == suite)
 
 
+def test_set_data_layouts():
+    suite = np.arange(128 * 256, dtype=np.uint16).reshape(128, 256)
+    # C-ordered, Fortran-ordered and strided inputs are all copied in one native call
+    for data in [suite, np.asfortranarray(suite), suite.T.copy().T, suite[::-1, ::2][::-1]]:
+        dx_object = pydicos.DXLoader()
+        dx_object.set_data(data)
+        assert dx_object.GetXRayData().GetWidth() == data.shape[1]
+        assert dx_object.GetXRayData().GetHeight() == data.shape[0]
+        assert np.array_equal(dx_object.get_data(), data)
+
+
+def test_get_data_dtypes_and_rescale():
+    for dtype in [np.int8, np.int16, np.uint32, np.float32]:
+        data = (np.arange(64 * 32) % 100).astype(dtype).reshape(64, 32)
+        dx_object = pydicos.DXLoader()
+        dx_object.set_data(data)
+        view = dx_object.get_data()
+        assert view.dtype == dtype
+        assert np.array_equal(view, data)
+        assert not np.shares_memory(dx_object.get_data(copy=True), view)
+
+        dx_object.SetRescaleSlope(2.0)
+        dx_object.SetRescaleIntercept(-10.0)
+        out = np.empty((64, 32), dtype=np.float32)
+        rescaled = dx_object.get_data(rescale=True, out=out)
+        assert rescaled is out or np.shares_memory(rescaled, out)
+        assert np.allclose(out, data.astype(np.float32) * 2.0 - 10.0)
+
+
 if __name__ == "__main__":
     test_loading_from_file_processing()
     test_loading_from_file_presentation()
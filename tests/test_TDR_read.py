@@ -4,6 +4,7 @@ import numpy as np
 import pydicos
 from pathlib import Path
 from pydicos import dcsread, TDR_DATA_TEMPLATE
+from pyDICOS import Bitmap, MemoryBuffer
 
 
 def test_invalid_dcs():
@@ -186,6 +187,46 @@ def test_set_data():
     assert data == TDR_DATA_TEMPLATE
 
 
+def test_bitmap_numpy_roundtrip():
+    mask = np.random.rand(7, 9, 13) > 0.5
+    bitmap = Bitmap.from_numpy(mask)
+    assert (bitmap.GetWidth(), bitmap.GetHeight(), bitmap.GetDepth()) == (13, 9, 7)
+    assert bitmap.GetNumBits() == mask.size
+    packed = np.frombuffer(bitmap.GetBitmap(), dtype=np.uint8)[:(mask.size + 7) // 8]
+    assert np.array_equal(packed, np.packbits(mask.ravel(), bitorder="little"))
+    assert np.array_equal(bitmap.to_numpy(), mask.astype(np.uint8))
+
+    # Any nonzero value is a set bit, whatever the data type
+    values = np.where(mask, 3.5, 0.0)
+    assert np.array_equal(Bitmap.from_numpy(values).to_numpy(), mask.astype(np.uint8))
+
+
+def test_memory_buffer_adopt_and_move():
+    data = np.arange(24, dtype=np.uint16).reshape(4, 6)
+    membuff = MemoryBuffer()
+    membuff.SetBuffer(data, bAdopt=True)
+    assert membuff.GetSize() == data.nbytes
+    assert not membuff.OwnsData()
+    view = np.frombuffer(membuff, dtype=np.uint16)
+    assert np.shares_memory(view, data)
+
+    membuff.SetBuffer(b"\x01\x02\x03\x04", 3)
+    assert membuff.OwnsData()
+    assert bytes(membuff) == b"\x01\x02\x03"
+
+    moved = membuff.move_to_memoryview()
+    assert membuff.GetSize() == 0
+    assert moved.tobytes() == b"\x01\x02\x03"
+
+    # Read-only memory cannot be handed to the SDK as writable
+    with pytest.raises(RuntimeError):
+        membuff.SetBuffer(b"\x01\x02\x03\x04", bAdopt=True)
+
+    # The memory buffer of a bitmap belongs to the bitmap, which could outlive the reference
+    bitmap = Bitmap.from_numpy(np.ones((2, 3, 4), dtype=np.uint8))
+    with pytest.raises(RuntimeError):
+        bitmap.GetBitmap().SetBuffer(data, bAdopt=True)
+
 if __name__ == "__main__":
     test_loading_no_threat()
     test_loading_baggage()
@@ -0,0 +1,275 @@
+import asyncio
+import threading
+import time
+from pathlib import Path
+
+import numpy as np
+import pydicos
+import pytest
+from pydicos import dcsread
+from pyDICOS import DX, TDR, ErrorLog, InFlightBudget, IngestReceiveCallback, QueuedReceiveCallback
+
+
+def make_tdr(instance_number):
+    tdr = TDR()
+    tdr.SetInstanceNumber(instance_number)
+    return tdr
+
+
+def make_dx():
+    dx = pydicos.DXLoader()
+    dx.set_data(np.zeros((128, 256), dtype=np.uint16))
+    return dx
+
+
+def test_budget_caps_bytes():
+    budget = InFlightBudget(nMaxBytes=1000)
+    assert budget.TryAcquire(600)
+    assert not budget.TryAcquire(600)
+    assert budget.GetBytesInFlight() == 600 and budget.GetObjectsInFlight() == 1
+    assert budget.TryAcquire(400)
+    assert not budget.HasRoom()
+
+    budget.Release(600)
+    assert budget.HasRoom()
+    assert budget.GetBytesInFlight() == 400 and budget.GetObjectsInFlight() == 1
+    assert budget.GetHighWaterBytes() == 1000
+
+
+def test_budget_caps_objects():
+    budget = InFlightBudget(nMaxObjects=3)
+    for _ in range(3):
+        assert budget.TryAcquire(0)
+    assert not budget.TryAcquire(0)
+    assert budget.GetObjectsInFlight() == 3
+
+
+def test_budget_lets_oversized_object_in_alone():
+    budget = InFlightBudget(nMaxBytes=1000)
+    assert budget.TryAcquire(5000)
+    assert not budget.TryAcquire(1)
+    budget.Release(5000)
+    assert budget.TryAcquire(1)
+
+
+def test_budget_acquire_times_out():
+    budget = InFlightBudget(nMaxObjects=1)
+    assert budget.TryAcquire(10)
+    start = time.monotonic()
+    assert not budget.Acquire(10, nTimeoutMilliseconds=50)
+    assert time.monotonic() - start >= 0.04
+    assert budget.GetNumberDelayed() == 1
+    assert budget.GetObjectsInFlight() == 1
+
+
+def test_budget_acquire_woken_by_release():
+    budget = InFlightBudget(nMaxObjects=1)
+    assert budget.TryAcquire(10)
+    releaser = threading.Timer(0.05, budget.Release, args=(10,))
+    releaser.start()
+    assert budget.Acquire(10, nTimeoutMilliseconds=5000)
+    releaser.join()
+    assert budget.GetObjectsInFlight() == 1
+
+
+def test_budget_is_a_hard_cap_across_threads():
+    budget = InFlightBudget(nMaxBytes=1000, nMaxObjects=2)
+
+    def worker():
+        for _ in range(200):
+            if budget.Acquire(400, nTimeoutMilliseconds=1000):
+                budget.Release(400)
+
+    threads = [threading.Thread(target=worker) for _ in range(8)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert budget.GetHighWaterBytes() <= 800
+    assert budget.GetBytesInFlight() == 0 and budget.GetObjectsInFlight() == 0
+
+
+def test_queue_is_fifo_and_drops_when_full():
+    callback = QueuedReceiveCallback(nCapacity=2)
+    assert callback.put(make_tdr(1))
+    assert callback.put(make_tdr(2))
+    assert not callback.put(make_tdr(3))
+
+    stats = callback.get_stats()
+    assert stats["received"] == 3 and stats["dropped"] == 1
+    assert stats["queued"] == 2 and stats["capacity"] == 2
+    assert callback.get_drops() == [{"modality": "TDR", "client_ip": "", "reason": "queue full"}]
+
+    first = callback.get_nowait()
+    assert first["modality"] == "TDR"
+    assert first["data"].GetInstanceNumber() == 1
+    assert callback.get(timeout=0)["data"].GetInstanceNumber() == 2
+    assert callback.get_nowait() is None
+
+
+def test_queue_get_waits_for_put():
+    callback = QueuedReceiveCallback()
+    producer = threading.Timer(0.05, callback.put, args=(make_tdr(1),))
+    producer.start()
+    received = callback.get(timeout=5)
+    producer.join()
+    assert received is not None and received["data"].GetInstanceNumber() == 1
+
+
+def test_queue_close_drains():
+    callback = QueuedReceiveCallback()
+    assert callback.get(timeout=0.05) is None
+    assert callback.put(make_tdr(1))
+    callback.Close()
+    assert callback.IsClosed()
+    assert not callback.put(make_tdr(2))
+    assert [received["data"].GetInstanceNumber() for received in callback] == [1]
+    assert callback.get() is None
+
+
+def test_queue_drains_after_close():
+    callback = QueuedReceiveCallback()
+    assert callback.put(make_tdr(1))
+    callback.Close()
+    assert not callback.IsDrained()
+    assert callback.get_nowait()["data"].GetInstanceNumber() == 1
+    assert callback.IsDrained()
+
+
+def test_areceive_ends_once_drained():
+    callback = QueuedReceiveCallback()
+    assert callback.put(make_tdr(1))
+    assert callback.put(make_tdr(2))
+    callback.Close()
+
+    async def collect():
+        return [received["data"].GetInstanceNumber() async for received in pydicos.areceive(callback, timeout=0.01)]
+
+    assert asyncio.run(collect()) == [1, 2]
+
+
+def test_queue_counts_in_flight_bytes():
+    dx = make_dx()
+    assert InFlightBudget.EstimateSizeInBytes(dx) == 128 * 256 * 2
+    assert InFlightBudget.EstimateSizeInBytes(TDR()) == 0
+
+    callback = QueuedReceiveCallback()
+    callback.SetInFlightBudget(nMaxBytes=100000, nMaxObjects=0, nMaxDelayMilliseconds=0)
+    assert callback.put(dx)
+    assert callback.GetBytesInFlight() == 128 * 256 * 2
+    assert not callback.put(dx)
+
+    # Threat reports only count as objects
+    assert callback.put(TDR())
+    stats = callback.get_stats()
+    assert stats["dropped"] == 1 and stats["rejected"] == 1
+    assert [drop["reason"] for drop in callback.get_drops()] == ["over the in-flight budget"]
+    assert stats["in_flight_bytes"] == 128 * 256 * 2 and stats["in_flight_objects"] == 2
+
+    received = callback.get_nowait()
+    assert received["modality"] == "DX"
+    assert isinstance(received["data"], DX)
+    callback.get_nowait()
+    assert callback.GetBytesInFlight() == 0 and callback.GetObjectsInFlight() == 0
+
+
+def test_queue_put_waits_for_consumer():
+    callback = QueuedReceiveCallback()
+    callback.SetInFlightBudget(nMaxBytes=0, nMaxObjects=1, nMaxDelayMilliseconds=5000)
+    assert callback.put(make_tdr(1))
+
+    consumer = threading.Timer(0.05, callback.get_nowait)
+    consumer.start()
+    assert callback.put(make_tdr(2))
+    consumer.join()
+    stats = callback.get_stats()
+    assert stats["delayed"] == 1 and stats["dropped"] == 0
+
+
+def read_tdr():
+    tdr = pydicos.TDRLoader()
+    dcsread(filename=Path("TDRFiles", "SimpleBaggageNoThreatTDR.dcs"), dcs=tdr)
+    return tdr
+
+
+def wait_drained(callback):
+    callback.Close()
+    while not callback.IsDrained():
+        time.sleep(0.01)
+
+
+@pytest.mark.order(after="tests/test_TDR_write.py::test_no_threat_tdr")
+def test_ingest_writes_and_hands_over(tmp_path):
+    tdr = read_tdr()
+    uid = tdr.GetSopInstanceUID().Get()
+    callback = IngestReceiveCallback(nNumWorkers=2, strOutputFolder=str(tmp_path), bHandToPython=True)
+    for _ in range(3):
+        assert callback.put(tdr)
+
+    filenames = []
+    for _ in range(3):
+        received = callback.get(timeout=5)
+        assert received["modality"] == "TDR"
+        filenames.append(received["filename"])
+    wait_drained(callback)
+
+    # Copies of one object share its SOP Instance UID and get numbered
+    names = [f"TDR_{uid}.dcs", f"TDR_{uid}_1.dcs", f"TDR_{uid}_2.dcs"]
+    assert sorted(filenames) == sorted(str(tmp_path / name) for name in names)
+    assert all(Path(filename).is_file() for filename in filenames)
+    stats = callback.get_stats()
+    assert stats["written"] == 3 and stats["write_errors"] == 0 and stats["workers"] == 2
+    assert stats["in_progress"] == 0 and stats["output_queued"] == 0
+
+
+@pytest.mark.order(after="tests/test_TDR_write.py::test_no_threat_tdr")
+def test_ingest_never_overwrites(tmp_path):
+    tdr = read_tdr()
+    uid = tdr.GetSopInstanceUID().Get()
+    earlier = tmp_path / f"TDR_{uid}.dcs"
+    earlier.write_bytes(b"earlier run")
+
+    # Nothing is handed over by default when writing, so no consumer is needed
+    callback = IngestReceiveCallback(nNumWorkers=2, strOutputFolder=str(tmp_path))
+    assert not callback.IsHandingToPython()
+    assert callback.put(tdr)
+    assert callback.put(tdr)
+    wait_drained(callback)
+
+    assert earlier.read_bytes() == b"earlier run"
+    assert (tmp_path / f"TDR_{uid}_1.dcs").is_file()
+    assert (tmp_path / f"TDR_{uid}_2.dcs").is_file()
+    stats = callback.get_stats()
+    assert stats["written"] == 2 and stats["write_errors"] == 0 and stats["dropped"] == 0
+
+
+def test_ingest_keeps_write_errors(tmp_path):
+    callback = IngestReceiveCallback(nNumWorkers=1, strOutputFolder=str(tmp_path / "missing"), bHandToPython=True)
+    assert callback.put(make_tdr(1))
+    received = callback.get(timeout=5)
+    assert received["filename"] == ""
+    wait_drained(callback)
+
+    errors = callback.get_write_errors()
+    assert callback.get_stats()["write_errors"] == len(errors) == 1
+    assert errors[0]["modality"] == "TDR"
+    assert errors[0]["filename"].startswith(str(tmp_path / "missing" / "TDR_"))
+    assert isinstance(errors[0]["errorlog"], ErrorLog)
+
+
+def test_areceive_cancel_keeps_queued_objects():
+    callback = QueuedReceiveCallback()
+
+    async def first():
+        async for received in pydicos.areceive(callback, timeout=0.01):
+            return received
+
+    async def scenario():
+        waiting = asyncio.ensure_future(first())
+        await asyncio.sleep(0.05)
+        waiting.cancel()
+        callback.put(make_tdr(1))
+        callback.Close()
+        return await first()
+
+    assert asyncio.run(scenario())["data"].GetInstanceNumber() == 1